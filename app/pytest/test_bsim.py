@@ -0,0 +1,31 @@
+# SPDX-License-Identifier: Apache-2.0
+"""Pairing / GATT benchmark on BabbleSim, run by Twister for app.bsim.
+
+Sysbuild builds the app and bench/bsim_central side by side; run.sh runs
+them against the simulated phy and fails when a metric crosses
+bench/bsim_central/thresholds.conf, which fails the test.
+"""
+
+import os
+import pathlib
+import subprocess
+
+import pytest
+
+RUN_SH = pathlib.Path(__file__).resolve().parents[2] / "bench" / "bsim_central" / "run.sh"
+
+
+def test_bsim_thresholds(request):
+    if not os.environ.get("BSIM_OUT_PATH"):
+        pytest.fail("BSIM_OUT_PATH must point to the BabbleSim output directory")
+
+    build_dir = pathlib.Path(request.config.getoption("--build-dir"))
+    env = dict(os.environ,
+               APP_EXE=str(build_dir / "app" / "zephyr" / "zephyr.exe"),
+               CENTRAL_EXE=str(build_dir / "bsim_central" / "zephyr" / "zephyr.exe"))
+
+    proc = subprocess.run([str(RUN_SH), str(build_dir / "bench_bsim.json")], env=env,
+                          stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True,
+                          timeout=600)
+    print(proc.stdout)
+    assert proc.returncode == 0, "BabbleSim benchmark failed or crossed thresholds.conf"
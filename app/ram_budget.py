@@ -0,0 +1,183 @@
+#!/usr/bin/env python3
+"""Per-module RAM report from a GNU ld map file.
+
+Every input section placed in a writable memory region (.data, .bss,
+.noinit, kernel object areas) is charged to the module that owns its object
+file: app/<file> for the application, drivers/<name> for this repository's
+drivers, and lvgl, bluetooth, kernel, ... for Zephyr. The system heap and
+the LVGL pool are reported on their own as heap/system and heap/lvgl.
+
+Limits come from a budget file with lines of "<module|group|glob|total> max
+<bytes>", e.g. "app/* max 8192". Run after each build by app/CMakeLists.txt
+with CONFIG_APP_STATIC_MEM and --strict, so an exceeded budget fails the
+build.
+
+Usage: ram_budget.py --map zephyr.map [--budget ram_budget.conf]
+                     [--out ram_budget.json] [--strict]
+"""
+
+import argparse
+import fnmatch
+import json
+import re
+import sys
+
+# Input section name -> module, checked first
+SECTION_RULES = [
+    (re.compile(r"kheap_buf__system_heap"), "heap/system"),
+    (re.compile(r"lvgl_heap_mem"), "heap/lvgl"),
+]
+
+# Object file path -> module, first match wins
+OBJECT_RULES = [
+    (re.compile(r"libapp\.a\((\w+)\.c\.obj\)"), "app/{0}"),
+    (re.compile(r"__drivers__([A-Z][A-Za-z0-9_]*)\.a\("), "drivers/{0}"),
+    (re.compile(r"bluetooth"), "bluetooth"),
+    (re.compile(r"lvgl"), "lvgl"),
+    (re.compile(r"libkernel\.a"), "kernel"),
+    (re.compile(r"libdrivers__|/drivers/"), "zephyr/drivers"),
+    (re.compile(r"libsubsys__(\w+?)(?:__\w+)?\.a"), "subsys/{0}"),
+    (re.compile(r"libarch__|/arch/|libsoc__|/soc/"), "arch"),
+    (re.compile(r"libzephyr\.a"), "zephyr/lib"),
+    (re.compile(r"libc\b|picolibc|newlib|libgcc|libnosys"), "libc"),
+]
+
+INPUT_ONE_LINE = re.compile(r"^ (\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)(?:\s+(\S.*?))?\s*$")
+INPUT_NAME = re.compile(r"^ (\S+)$")
+INPUT_ADDR = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+REGION = re.compile(r"^(\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)(?:\s+(\S+))?$")
+
+
+def module_of(section, obj):
+    for rule, name in SECTION_RULES:
+        if rule.search(section):
+            return name
+    for rule, fmt in OBJECT_RULES:
+        m = rule.search(obj)
+        if m:
+            return fmt.format(*m.groups())
+    # Unknown archive: its file name, e.g. libfoo.a(bar.c.obj) -> libfoo
+    m = re.search(r"([^/\\(]+?)(?:\.a)?\(", obj)
+    return m.group(1) if m else "other"
+
+
+def parse_map(path):
+    """Return ({region: (origin, length)}, [(section, addr, size, obj)])."""
+    regions = {}
+    sections = []
+    state = None
+    pending = None
+
+    with open(path, encoding="utf-8", errors="replace") as f:
+        for line in f:
+            line = line.rstrip("\n")
+            if line.startswith("Memory Configuration"):
+                state = "regions"
+                continue
+            if line.startswith("Linker script and memory map"):
+                state = "map"
+                continue
+            if state == "regions":
+                m = REGION.match(line)
+                # Writable regions hold RAM; IDT_LIST is a build artefact
+                if m and m.group(4) and "w" in m.group(4) and \
+                        m.group(1) not in ("IDT_LIST", "*default*"):
+                    regions[m.group(1)] = (int(m.group(2), 16), int(m.group(3), 16))
+                continue
+            if state != "map":
+                continue
+
+            m = INPUT_ONE_LINE.match(line)
+            if m:
+                sections.append((m.group(1), int(m.group(2), 16), int(m.group(3), 16),
+                                 m.group(4)))
+                pending = None
+                continue
+            m = INPUT_NAME.match(line)
+            if m:
+                pending = m.group(1)
+                continue
+            m = INPUT_ADDR.match(line)
+            if m and pending:
+                sections.append((pending, int(m.group(1), 16), int(m.group(2), 16),
+                                 m.group(3)))
+            pending = None
+    return regions, sections
+
+
+def in_ram(regions, addr):
+    return any(origin <= addr < origin + length for origin, length in regions.values())
+
+
+def read_budget(path):
+    limits = []
+    with open(path, encoding="utf-8") as f:
+        for line in f:
+            line = line.split("#", 1)[0].strip()
+            if not line:
+                continue
+            name, kind, value = line.split()
+            if kind != "max":
+                raise ValueError(f"{path}: only 'max' limits are supported: {line}")
+            limits.append((name, int(value, 0)))
+    return limits
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--map", required=True, help="linker map file (zephyr.map)")
+    parser.add_argument("--budget", help="budget file")
+    parser.add_argument("--out", help="write the report as JSON")
+    parser.add_argument("--strict", action="store_true", help="fail when over budget")
+    args = parser.parse_args()
+
+    regions, sections = parse_map(args.map)
+    if not regions:
+        print("ram_budget: no writable memory region in the map", file=sys.stderr)
+        return 1
+
+    modules = {}
+    for section, addr, size, obj in sections:
+        if not size or not in_ram(regions, addr):
+            continue
+        name = "fill" if section == "*fill*" else module_of(section, obj)
+        modules[name] = modules.get(name, 0) + size
+
+    groups = {}
+    for name, size in modules.items():
+        group = name.split("/", 1)[0]
+        groups[group] = groups.get(group, 0) + size
+    total = sum(modules.values())
+    ram = sum(length for _, length in regions.values())
+
+    print(f"RAM by module: {total} of {ram} bytes")
+    for group in sorted(groups, key=groups.get, reverse=True):
+        print(f"  {group:<24} {groups[group]:>8}")
+        members = [m for m in modules if m.split("/", 1)[0] == group and m != group]
+        for name in sorted(members, key=modules.get, reverse=True):
+            print(f"    {name:<22} {modules[name]:>8}")
+
+    over = []
+    if args.budget:
+        sizes = dict(groups)
+        sizes.update(modules)
+        sizes["total"] = total
+        for pattern, limit in read_budget(args.budget):
+            for name in sorted(n for n in sizes if fnmatch.fnmatchcase(n, pattern)):
+                if sizes[name] > limit:
+                    over.append({"module": name, "size": sizes[name], "max": limit})
+        for o in over:
+            print(f"OVER BUDGET {o['module']}: {o['size']} > {o['max']} bytes",
+                  file=sys.stderr)
+
+    if args.out:
+        with open(args.out, "w", encoding="utf-8") as f:
+            json.dump({"total": total, "ram": ram, "groups": groups, "modules": modules,
+                       "over": over}, f, indent=2, sort_keys=True)
+            f.write("\n")
+
+    return 1 if (over and args.strict) else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
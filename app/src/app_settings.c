@@ -0,0 +1,286 @@
+/**
+ * @file app_settings.c
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/settings/settings.h>
+#include <zephyr/sys/iterable_sections.h>
+#include <zephyr/zbus/zbus.h>
+
+#ifdef CONFIG_SHELL
+#include <zephyr/shell/shell.h>
+#endif
+
+#include "app_settings.h"
+#include "events.h"
+
+LOG_MODULE_REGISTER(app_settings, CONFIG_APP_LOG_LEVEL);
+
+/* --------------------------------------------------------------------------
+ * Constants
+ * -------------------------------------------------------------------------- */
+#define SETTINGS_SUBTREES_MAX CONFIG_APP_SETTINGS_SUBTREES_MAX
+#define SETTINGS_SLOTS        CONFIG_APP_SETTINGS_WRITE_SLOTS
+#define SETTINGS_VALUE_MAX    CONFIG_APP_SETTINGS_VALUE_MAX
+#define SETTINGS_FLUSH_DELAY  K_MSEC(CONFIG_APP_SETTINGS_FLUSH_DELAY_MS)
+
+/* --------------------------------------------------------------------------
+ * Types
+ * -------------------------------------------------------------------------- */
+struct settings_slot {
+    const char *name;      /* NULL: free */
+    uint8_t     len;
+    uint8_t     value[SETTINGS_VALUE_MAX];
+};
+
+/* --------------------------------------------------------------------------
+ * Global States
+ * -------------------------------------------------------------------------- */
+K_THREAD_STACK_DEFINE(settings_wq_stack, CONFIG_APP_SETTINGS_STACK_SIZE);
+static struct k_work_q settings_wq;
+
+static struct k_work           settings_load_work;
+static struct k_work_delayable settings_flush_work;
+
+static K_MUTEX_DEFINE(settings_lock);
+static struct settings_slot             settings_slots[SETTINGS_SLOTS];
+static struct app_settings_write_stats  settings_write_stats;
+static struct app_settings_subtree_stat settings_load_stats[SETTINGS_SUBTREES_MAX];
+static size_t                           settings_load_count;
+
+/* --------------------------------------------------------------------------
+ * Private Functions
+ * -------------------------------------------------------------------------- */
+/* true if name is root itself or below it */
+static bool settings_is_under(const char *name, const char *root)
+{
+    size_t len = strlen(root);
+
+    return !strncmp(name, root, len) && (name[len] == '\0' || name[len] == '/');
+}
+
+static int settings_load_timed(const char *name)
+{
+    uint32_t start = k_cycle_get_32();
+    int err = settings_load_subtree(name);
+    uint32_t us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+    k_mutex_lock(&settings_lock, K_FOREVER);
+    if (settings_load_count < SETTINGS_SUBTREES_MAX) {
+        settings_load_stats[settings_load_count++] = (struct app_settings_subtree_stat){
+            .name = name, .load_us = us, .err = err,
+        };
+    }
+    k_mutex_unlock(&settings_lock);
+
+    if (err) {
+        LOG_ERR("[SET] Loading \"%s\" failed (err %d)", name, err);
+    } else {
+        LOG_DBG("[SET] Loaded \"%s\" in %u us", name, us);
+    }
+    return err;
+}
+
+/* Every static handler outside "bt" that isn't below another handler (or a
+ * duplicate of an earlier one), so each subtree is read exactly once */
+static void settings_load_handler(struct k_work *work)
+{
+    STRUCT_SECTION_FOREACH(settings_handler_static, h) {
+        bool skip = settings_is_under(h->name, "bt");
+
+        STRUCT_SECTION_FOREACH(settings_handler_static, other) {
+            if (skip) {
+                break;
+            } else if (other != h) {
+                skip = strcmp(h->name, other->name) ?
+                       settings_is_under(h->name, other->name) : (other < h);
+            }
+        }
+        if (!skip) {
+            settings_load_timed(h->name);
+        }
+    }
+}
+
+static void settings_flush_handler(struct k_work *work)
+{
+    app_settings_flush();
+}
+
+/* Connection setup and pairing follow a connection event: keep flash busy
+ * elsewhere until the link went quiet */
+static void settings_conn_activity(const struct zbus_channel *chan)
+{
+    if (k_work_delayable_is_pending(&settings_flush_work)) {
+        k_work_reschedule_for_queue(&settings_wq, &settings_flush_work, SETTINGS_FLUSH_DELAY);
+    }
+}
+
+ZBUS_LISTENER_DEFINE(settings_lis, settings_conn_activity);
+ZBUS_CHAN_ADD_OBS(conn_chan, settings_lis, 0);
+ZBUS_CHAN_ADD_OBS(sec_chan, settings_lis, 0);
+
+/* --------------------------------------------------------------------------
+ * Public Functions
+ * -------------------------------------------------------------------------- */
+int app_settings_load_bt(void)
+{
+    return settings_load_timed("bt");
+}
+
+void app_settings_load_deferred(void)
+{
+    k_work_submit_to_queue(&settings_wq, &settings_load_work);
+}
+
+int app_settings_save(const char *name, const void *value, size_t len)
+{
+    struct settings_slot *slot = NULL;
+
+    if (len > SETTINGS_VALUE_MAX) {
+        return -EINVAL;
+    }
+
+    k_mutex_lock(&settings_lock, K_FOREVER);
+    settings_write_stats.requested++;
+    for (size_t i = 0; i < SETTINGS_SLOTS; i++) {
+        if (settings_slots[i].name && !strcmp(settings_slots[i].name, name)) {
+            slot = &settings_slots[i];
+            settings_write_stats.coalesced++;
+            break;
+        } else if (!settings_slots[i].name && !slot) {
+            slot = &settings_slots[i];
+        }
+    }
+    if (slot) {
+        slot->name = name;
+        slot->len  = len;
+        memcpy(slot->value, value, len);
+    }
+    k_mutex_unlock(&settings_lock);
+
+    if (!slot) {
+        return -ENOMEM;
+    }
+    k_work_reschedule_for_queue(&settings_wq, &settings_flush_work, SETTINGS_FLUSH_DELAY);
+    return 0;
+}
+
+int app_settings_flush(void)
+{
+    struct settings_slot pending[SETTINGS_SLOTS];
+    uint32_t written = 0;
+    uint32_t failed = 0;
+    int ret = 0;
+
+    k_mutex_lock(&settings_lock, K_FOREVER);
+    memcpy(pending, settings_slots, sizeof(pending));
+    memset(settings_slots, 0, sizeof(settings_slots));
+    k_mutex_unlock(&settings_lock);
+
+    uint32_t start = k_cycle_get_32();
+
+    for (size_t i = 0; i < SETTINGS_SLOTS; i++) {
+        if (!pending[i].name) {
+            continue;
+        }
+        int err = settings_save_one(pending[i].name, pending[i].value, pending[i].len);
+
+        if (err) {
+            LOG_ERR("[SET] Writing \"%s\" failed (err %d)", pending[i].name, err);
+            ret = ret ? ret : err;
+            failed++;
+        } else {
+            written++;
+        }
+    }
+    uint32_t us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+    if (written || failed) {
+        k_mutex_lock(&settings_lock, K_FOREVER);
+        settings_write_stats.written += written;
+        settings_write_stats.failed  += failed;
+        settings_write_stats.flushes++;
+        settings_write_stats.flush_max_us = MAX(settings_write_stats.flush_max_us, us);
+        k_mutex_unlock(&settings_lock);
+    }
+    return ret;
+}
+
+size_t app_settings_load_stats_get(struct app_settings_subtree_stat *out, size_t max)
+{
+    k_mutex_lock(&settings_lock, K_FOREVER);
+    size_t n = MIN(max, settings_load_count);
+
+    memcpy(out, settings_load_stats, n * sizeof(*out));
+    k_mutex_unlock(&settings_lock);
+    return n;
+}
+
+void app_settings_write_stats_get(struct app_settings_write_stats *out)
+{
+    k_mutex_lock(&settings_lock, K_FOREVER);
+    *out = settings_write_stats;
+    k_mutex_unlock(&settings_lock);
+}
+
+static int app_settings_init(void)
+{
+    const struct k_work_queue_config cfg = {.name = "settings_wq"};
+    int err = settings_subsys_init();
+
+    k_work_init(&settings_load_work, settings_load_handler);
+    k_work_init_delayable(&settings_flush_work, settings_flush_handler);
+    k_work_queue_start(&settings_wq, settings_wq_stack,
+                       K_THREAD_STACK_SIZEOF(settings_wq_stack),
+                       CONFIG_APP_SETTINGS_PRIORITY, &cfg);
+    return err;
+}
+
+SYS_INIT(app_settings_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+/* --------------------------------------------------------------------------
+ * Shell Commands
+ * -------------------------------------------------------------------------- */
+#ifdef CONFIG_SHELL
+static int cmd_store_load(const struct shell *sh, size_t argc, char **argv)
+{
+    struct app_settings_subtree_stat st[SETTINGS_SUBTREES_MAX];
+    size_t n = app_settings_load_stats_get(st, ARRAY_SIZE(st));
+
+    shell_print(sh, "%-16s %10s %5s", "subtree", "load[us]", "err");
+    for (size_t i = 0; i < n; i++) {
+        shell_print(sh, "%-16s %10u %5d", st[i].name, st[i].load_us, st[i].err);
+    }
+    return 0;
+}
+
+static int cmd_store_writes(const struct shell *sh, size_t argc, char **argv)
+{
+    struct app_settings_write_stats st;
+
+    app_settings_write_stats_get(&st);
+    shell_print(sh, "%u saves, %u coalesced, %u written, %u failed, %u flushes (max %u us)",
+                st.requested, st.coalesced, st.written, st.failed, st.flushes,
+                st.flush_max_us);
+    return 0;
+}
+
+static int cmd_store_flush(const struct shell *sh, size_t argc, char **argv)
+{
+    return app_settings_flush();
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(store_cmds,
+    SHELL_CMD(load, NULL, "Load time per settings subtree", cmd_store_load),
+    SHELL_CMD(writes, NULL, "Batched write counters", cmd_store_writes),
+    SHELL_CMD(flush, NULL, "Write pending values now", cmd_store_flush),
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(store, &store_cmds, "Settings loading and batched writes", NULL);
+#endif /* CONFIG_SHELL */
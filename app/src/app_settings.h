@@ -0,0 +1,91 @@
+/**
+ * @file app_settings.h
+ * @brief Subtree-ordered settings loading and batched settings writes
+ *
+ * The "bt" subtree (identity, keys, CCCs) is loaded first so advertising
+ * can start; every other statically registered subtree is loaded later on
+ * a low-priority work queue. Writes made through app_settings_save() are
+ * coalesced in RAM and flushed on the same queue once no write or
+ * connection event happened for CONFIG_APP_SETTINGS_FLUSH_DELAY_MS, so
+ * flash writes and erases stay off the connection path.
+ */
+
+#ifndef APP_SETTINGS_H
+#define APP_SETTINGS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* --------------------------------------------------------------------------
+ * Types
+ * -------------------------------------------------------------------------- */
+struct app_settings_subtree_stat {
+    const char *name;
+    uint32_t    load_us;
+    int         err;
+};
+
+struct app_settings_write_stats {
+    uint32_t requested;    /* app_settings_save() calls */
+    uint32_t coalesced;    /* saves that replaced a pending value */
+    uint32_t written;      /* values written to the backend */
+    uint32_t failed;
+    uint32_t flushes;
+    uint32_t flush_max_us;
+};
+
+/* --------------------------------------------------------------------------
+ * Public Functions
+ * -------------------------------------------------------------------------- */
+/**
+ * @brief Load the "bt" subtree now
+ *
+ * Call from bt_ready(), before advertising starts.
+ *
+ * @return Error code, < 0 on failures
+ */
+int app_settings_load_bt(void);
+
+/**
+ * @brief Queue loading of every other static subtree, one at a time
+ */
+void app_settings_load_deferred(void);
+
+/**
+ * @brief Stage a value for a batched write
+ *
+ * A pending value for the same name is replaced.
+ *
+ * @param [in] name  Full settings name, must stay valid (string literal)
+ * @param [in] value Value, at most CONFIG_APP_SETTINGS_VALUE_MAX bytes
+ * @param [in] len   Length of value
+ *
+ * @return Error code, < 0 on failures (-ENOMEM if no slot is free)
+ */
+int app_settings_save(const char *name, const void *value, size_t len);
+
+/**
+ * @brief Write every pending value now, from the calling thread
+ *
+ * @return Error code of the first failed write, 0 otherwise
+ */
+int app_settings_flush(void);
+
+/**
+ * @brief Copy the per-subtree load results, in load order
+ *
+ * @param [out] out Destination array
+ * @param [in]  max Number of entries out can hold
+ *
+ * @return Number of entries copied
+ */
+size_t app_settings_load_stats_get(struct app_settings_subtree_stat *out, size_t max);
+
+/**
+ * @brief Copy the write batching counters
+ *
+ * @param [out] out Destination
+ */
+void app_settings_write_stats_get(struct app_settings_write_stats *out);
+
+#endif /* APP_SETTINGS_H */
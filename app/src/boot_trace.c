@@ -0,0 +1,116 @@
+/**
+ * @file boot_trace.c
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#ifdef CONFIG_SHELL
+#include <zephyr/shell/shell.h>
+#endif
+
+#include "boot_trace.h"
+
+LOG_MODULE_REGISTER(boot_trace, CONFIG_APP_LOG_LEVEL);
+
+/* --------------------------------------------------------------------------
+ * Global States
+ * -------------------------------------------------------------------------- */
+static const char *const boot_stage_names[BOOT_STAGE_COUNT] = {
+    [BOOT_STAGE_MAIN]            = "main",
+    [BOOT_STAGE_DRIVERS]         = "drivers",
+    [BOOT_STAGE_BT_REQUESTED]    = "bt_requested",
+    [BOOT_STAGE_UI_INIT]         = "ui_init",
+    [BOOT_STAGE_FIRST_FRAME]     = "first_frame",
+    [BOOT_STAGE_BT_READY]        = "bt_ready",
+    [BOOT_STAGE_SETTINGS_LOADED] = "settings_loaded",
+    [BOOT_STAGE_ADV_STARTED]     = "adv_started",
+};
+
+/* Ticks + 1 so that 0 means "not reached" even for a mark at tick 0 */
+static int64_t boot_ticks[BOOT_STAGE_COUNT];
+
+/* --------------------------------------------------------------------------
+ * Private Functions
+ * -------------------------------------------------------------------------- */
+/* Reached stages, earliest first */
+static size_t boot_trace_sorted(uint8_t order[BOOT_STAGE_COUNT])
+{
+    size_t n = 0;
+
+    for (uint8_t s = 0; s < BOOT_STAGE_COUNT; s++) {
+        if (!boot_ticks[s]) {
+            continue;
+        }
+        size_t i = n++;
+
+        while (i > 0 && boot_ticks[order[i - 1]] > boot_ticks[s]) {
+            order[i] = order[i - 1];
+            i--;
+        }
+        order[i] = s;
+    }
+    return n;
+}
+
+/* --------------------------------------------------------------------------
+ * Public Functions
+ * -------------------------------------------------------------------------- */
+void boot_trace_mark(boot_stage_t stage)
+{
+    int64_t now = k_uptime_ticks() + 1;
+    unsigned int key = irq_lock();
+
+    if (!boot_ticks[stage]) {
+        boot_ticks[stage] = now;
+    }
+    irq_unlock(key);
+}
+
+uint32_t boot_trace_get_us(boot_stage_t stage)
+{
+    int64_t ticks = boot_ticks[stage];
+
+    return ticks ? (uint32_t)k_ticks_to_us_floor64(ticks - 1) : 0U;
+}
+
+void boot_trace_log(void)
+{
+    uint8_t order[BOOT_STAGE_COUNT];
+    size_t n = boot_trace_sorted(order);
+    uint32_t prev_us = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        uint32_t us = boot_trace_get_us(order[i]);
+
+        LOG_INF("[BOOT] %-16s %8u us (+%u us)", boot_stage_names[order[i]], us, us - prev_us);
+        prev_us = us;
+    }
+    if (boot_ticks[BOOT_STAGE_ADV_STARTED]) {
+        LOG_INF("[BOOT] First advertisement %u us after kernel start",
+                boot_trace_get_us(BOOT_STAGE_ADV_STARTED));
+    }
+}
+
+/* --------------------------------------------------------------------------
+ * Shell Commands
+ * -------------------------------------------------------------------------- */
+#ifdef CONFIG_SHELL
+static int cmd_boot(const struct shell *sh, size_t argc, char **argv)
+{
+    uint8_t order[BOOT_STAGE_COUNT];
+    size_t n = boot_trace_sorted(order);
+    uint32_t prev_us = 0;
+
+    shell_print(sh, "%-16s %10s %10s", "stage", "t[us]", "delta[us]");
+    for (size_t i = 0; i < n; i++) {
+        uint32_t us = boot_trace_get_us(order[i]);
+
+        shell_print(sh, "%-16s %10u %10u", boot_stage_names[order[i]], us, us - prev_us);
+        prev_us = us;
+    }
+    return 0;
+}
+
+SHELL_CMD_REGISTER(boot, NULL, "Boot stage timestamps", cmd_boot);
+#endif /* CONFIG_SHELL */
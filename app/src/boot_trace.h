@@ -0,0 +1,67 @@
+/**
+ * @file boot_trace.h
+ * @brief Timestamped boot stages and time to first advertisement
+ *
+ * Call BOOT_MARK(stage) when a stage completes. Stages may complete on
+ * different threads (display bring-up on main, BT init in bt_ready()), so
+ * the report is ordered by time. Times are kernel uptime, i.e. from the
+ * start of the kernel, not from reset. Compiles away unless
+ * CONFIG_APP_BOOT_TRACE is set.
+ */
+
+#ifndef BOOT_TRACE_H
+#define BOOT_TRACE_H
+
+#include <stdint.h>
+
+/* --------------------------------------------------------------------------
+ * Types
+ * -------------------------------------------------------------------------- */
+typedef enum {
+    BOOT_STAGE_MAIN = 0,        /* main() entered */
+    BOOT_STAGE_DRIVERS,         /* buttons and LEDs ready */
+    BOOT_STAGE_BT_REQUESTED,    /* bt_enable() returned, init runs async */
+    BOOT_STAGE_UI_INIT,         /* LVGL objects created */
+    BOOT_STAGE_FIRST_FRAME,     /* first screen flushed */
+    BOOT_STAGE_BT_READY,        /* bt_ready() called */
+    BOOT_STAGE_SETTINGS_LOADED, /* bonds and identity restored */
+    BOOT_STAGE_ADV_STARTED,     /* first advertisement scheduled */
+    BOOT_STAGE_COUNT,
+} boot_stage_t;
+
+/* --------------------------------------------------------------------------
+ * Public Functions
+ * -------------------------------------------------------------------------- */
+#ifdef CONFIG_APP_BOOT_TRACE
+
+#define BOOT_MARK(stage) boot_trace_mark(stage)
+
+/**
+ * @brief Record that a stage completed now. Later marks of the same stage
+ *        are ignored.
+ *
+ * @param [in] stage The stage
+ */
+void boot_trace_mark(boot_stage_t stage);
+
+/**
+ * @brief Get the uptime at which a stage completed
+ *
+ * @param [in] stage The stage
+ *
+ * @return Microseconds since kernel start, 0 if not reached yet
+ */
+uint32_t boot_trace_get_us(boot_stage_t stage);
+
+/**
+ * @brief Log every reached stage in time order with its delta
+ */
+void boot_trace_log(void);
+
+#else
+
+#define BOOT_MARK(stage)
+
+#endif /* CONFIG_APP_BOOT_TRACE */
+
+#endif /* BOOT_TRACE_H */
@@ -0,0 +1,118 @@
+/**
+ * @file cb_prof.c
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/timing/timing.h>
+
+#ifdef CONFIG_SHELL
+#include <zephyr/shell/shell.h>
+#endif
+
+#include "cb_prof.h"
+
+LOG_MODULE_REGISTER(cb_prof, CONFIG_APP_LOG_LEVEL);
+
+/* --------------------------------------------------------------------------
+ * Global States
+ * -------------------------------------------------------------------------- */
+static const char *const cb_names[CB_PROF_COUNT] = {
+    [CB_PROF_CONNECTED]        = "connected",
+    [CB_PROF_DISCONNECTED]     = "disconnected",
+    [CB_PROF_SECURITY_CHANGED] = "security_changed",
+    [CB_PROF_PASSKEY_DISPLAY]  = "passkey_display",
+    [CB_PROF_PASSKEY_CONFIRM]  = "passkey_confirm",
+    [CB_PROF_AUTH_CANCEL]      = "auth_cancel",
+    [CB_PROF_PAIRING_COMPLETE] = "pairing_complete",
+    [CB_PROF_PAIRING_FAILED]   = "pairing_failed",
+    [CB_PROF_GATT_READ]        = "read_secure_data",
+    [CB_PROF_GATT_WRITE]       = "write_secure_data",
+};
+
+static struct k_spinlock     prof_lock;
+static struct cb_prof_stats  prof_stats[CB_PROF_COUNT];
+
+/* --------------------------------------------------------------------------
+ * Public Functions
+ * -------------------------------------------------------------------------- */
+void cb_prof_record(cb_prof_id_t id, timing_t *start)
+{
+    timing_t end = timing_counter_get();
+    uint32_t ns  = (uint32_t)timing_cycles_to_ns(timing_cycles_get(start, &end));
+    k_spinlock_key_t key = k_spin_lock(&prof_lock);
+
+    prof_stats[id].count++;
+    prof_stats[id].total_ns += ns;
+    prof_stats[id].max_ns = MAX(prof_stats[id].max_ns, ns);
+    k_spin_unlock(&prof_lock, key);
+}
+
+void cb_prof_get(cb_prof_id_t id, struct cb_prof_stats *out)
+{
+    k_spinlock_key_t key = k_spin_lock(&prof_lock);
+
+    *out = prof_stats[id];
+    k_spin_unlock(&prof_lock, key);
+}
+
+void cb_prof_log(void)
+{
+    for (int i = 0; i < CB_PROF_COUNT; i++) {
+        struct cb_prof_stats st;
+
+        cb_prof_get(i, &st);
+        if (st.count) {
+            LOG_INF("%s: n=%u avg=%u ns max=%u ns", cb_names[i], st.count,
+                    (uint32_t)(st.total_ns / st.count), st.max_ns);
+        }
+    }
+}
+
+static int cb_prof_init(void)
+{
+    timing_init();
+    timing_start();
+    return 0;
+}
+
+SYS_INIT(cb_prof_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+/* --------------------------------------------------------------------------
+ * Shell Commands
+ * -------------------------------------------------------------------------- */
+#ifdef CONFIG_SHELL
+static int cmd_cbprof_show(const struct shell *sh, size_t argc, char **argv)
+{
+    shell_print(sh, "%-18s %8s %10s %10s", "callback", "n", "avg[ns]", "max[ns]");
+    for (int i = 0; i < CB_PROF_COUNT; i++) {
+        struct cb_prof_stats st;
+
+        cb_prof_get(i, &st);
+        shell_print(sh, "%-18s %8u %10u %10u", cb_names[i], st.count,
+                    st.count ? (uint32_t)(st.total_ns / st.count) : 0U,
+                    st.max_ns);
+    }
+    return 0;
+}
+
+static int cmd_cbprof_reset(const struct shell *sh, size_t argc, char **argv)
+{
+    k_spinlock_key_t key = k_spin_lock(&prof_lock);
+
+    memset(prof_stats, 0, sizeof(prof_stats));
+    k_spin_unlock(&prof_lock, key);
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(cbprof_cmds,
+    SHELL_CMD(show, NULL, "BT callback CPU time", cmd_cbprof_show),
+    SHELL_CMD(reset, NULL, "Clear callback statistics", cmd_cbprof_reset),
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(cbprof, &cbprof_cmds, "BT callback profiling", NULL);
+#endif /* CONFIG_SHELL */
@@ -0,0 +1,76 @@
+/**
+ * @file cb_prof.h
+ * @brief CPU time profiling of BT stack callbacks
+ *
+ * Wrap a callback body in CB_PROF_START() / CB_PROF_STOP(id) to accumulate
+ * count, average and worst-case execution time measured with the timing
+ * API. Compiles away unless CONFIG_APP_CB_PROFILE is set.
+ */
+
+#ifndef CB_PROF_H
+#define CB_PROF_H
+
+#include <stdint.h>
+
+/* --------------------------------------------------------------------------
+ * Types
+ * -------------------------------------------------------------------------- */
+typedef enum {
+    CB_PROF_CONNECTED = 0,
+    CB_PROF_DISCONNECTED,
+    CB_PROF_SECURITY_CHANGED,
+    CB_PROF_PASSKEY_DISPLAY,
+    CB_PROF_PASSKEY_CONFIRM,
+    CB_PROF_AUTH_CANCEL,
+    CB_PROF_PAIRING_COMPLETE,
+    CB_PROF_PAIRING_FAILED,
+    CB_PROF_GATT_READ,
+    CB_PROF_GATT_WRITE,
+    CB_PROF_COUNT,
+} cb_prof_id_t;
+
+struct cb_prof_stats {
+    uint32_t count;
+    uint64_t total_ns;
+    uint32_t max_ns;
+};
+
+/* --------------------------------------------------------------------------
+ * Public Functions
+ * -------------------------------------------------------------------------- */
+#ifdef CONFIG_APP_CB_PROFILE
+
+#include <zephyr/timing/timing.h>
+
+#define CB_PROF_START()   timing_t _cb_prof_start = timing_counter_get()
+#define CB_PROF_STOP(id)  cb_prof_record(id, &_cb_prof_start)
+
+/**
+ * @brief Account one callback execution that started at start
+ *
+ * @param [in] id    Which callback ran
+ * @param [in] start Counter value taken on entry
+ */
+void cb_prof_record(cb_prof_id_t id, timing_t *start);
+
+/**
+ * @brief Copy the statistics of one callback
+ *
+ * @param [in]  id  Which callback to read
+ * @param [out] out Destination
+ */
+void cb_prof_get(cb_prof_id_t id, struct cb_prof_stats *out);
+
+/**
+ * @brief Log a one-line summary per callback that has run
+ */
+void cb_prof_log(void);
+
+#else
+
+#define CB_PROF_START()
+#define CB_PROF_STOP(id)
+
+#endif /* CONFIG_APP_CB_PROFILE */
+
+#endif /* CB_PROF_H */
@@ -0,0 +1,388 @@
+/**
+ * @file conn_params.c
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/util.h>
+
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/conn.h>
+
+#include "conn_params.h"
+
+LOG_MODULE_REGISTER(conn_params, CONFIG_APP_LOG_LEVEL);
+
+/* --------------------------------------------------------------------------
+ * Constants
+ * -------------------------------------------------------------------------- */
+#define CONN_PARAMS_HISTORY_LEN   CONFIG_APP_CONN_PARAMS_HISTORY_LEN
+#define CONN_PARAMS_MAX_RETRIES   CONFIG_APP_CONN_PARAMS_MAX_RETRIES
+
+/* The stack holds back peripheral requests for CONFIG_BT_CONN_PARAM_UPDATE_TIMEOUT
+ * after connecting, so give the central that long plus the response window. */
+#define CONN_PARAMS_RESPONSE_MS \
+    (CONFIG_BT_CONN_PARAM_UPDATE_TIMEOUT + CONFIG_APP_CONN_PARAMS_RESPONSE_TIMEOUT_MS)
+
+#define CONN_PARAMS_RETRY_BASE_MS 1000
+#define CONN_PARAMS_INTERVAL_MAX  3200 /* 4 s, spec limit */
+#define CONN_PARAMS_TIMEOUT_MAX   3200 /* 32 s, spec limit */
+
+/* --------------------------------------------------------------------------
+ * Types
+ * -------------------------------------------------------------------------- */
+struct conn_params_ctx {
+    struct bt_conn           *conn;
+    conn_params_profile_t     target;    /* profile we want the link in */
+    conn_params_profile_t     active;    /* profile the link is actually in */
+    struct bt_le_conn_param   requested; /* last request sent to the central */
+    bool                      pending;
+    uint8_t                   retries;
+    struct k_work_delayable   idle_work;
+    struct k_work_delayable   request_work;
+    struct k_work_delayable   response_work;
+    struct conn_params_record history[CONN_PARAMS_HISTORY_LEN];
+    uint8_t                   history_head;
+    uint8_t                   history_count;
+};
+
+/* --------------------------------------------------------------------------
+ * Global States
+ * -------------------------------------------------------------------------- */
+static const struct bt_le_conn_param profile_params[] = {
+    [CONN_PARAMS_PROFILE_FAST] = {
+        .interval_min = CONFIG_APP_CONN_PARAMS_FAST_INTERVAL_MIN,
+        .interval_max = CONFIG_APP_CONN_PARAMS_FAST_INTERVAL_MAX,
+        .latency      = 0,
+        .timeout      = CONFIG_APP_CONN_PARAMS_FAST_TIMEOUT,
+    },
+    [CONN_PARAMS_PROFILE_IDLE] = {
+        .interval_min = CONFIG_APP_CONN_PARAMS_IDLE_INTERVAL_MIN,
+        .interval_max = CONFIG_APP_CONN_PARAMS_IDLE_INTERVAL_MAX,
+        .latency      = CONFIG_APP_CONN_PARAMS_IDLE_LATENCY,
+        .timeout      = CONFIG_APP_CONN_PARAMS_IDLE_TIMEOUT,
+    },
+};
+
+static const char *const profile_names[] = {
+    [CONN_PARAMS_PROFILE_NONE] = "central",
+    [CONN_PARAMS_PROFILE_FAST] = "fast",
+    [CONN_PARAMS_PROFILE_IDLE] = "idle",
+};
+
+static const char *const evt_names[] = {
+    [CONN_PARAMS_EVT_REQUESTED]   = "requested",
+    [CONN_PARAMS_EVT_APPLIED]     = "applied",
+    [CONN_PARAMS_EVT_REJECTED]    = "rejected",
+    [CONN_PARAMS_EVT_PEER_UPDATE] = "peer update",
+};
+
+static K_MUTEX_DEFINE(conn_params_mutex);
+static struct conn_params_ctx ctxs[CONFIG_BT_MAX_CONN];
+
+/* --------------------------------------------------------------------------
+ * Private Functions
+ * -------------------------------------------------------------------------- */
+static struct conn_params_ctx *ctx_get(struct bt_conn *conn)
+{
+    struct conn_params_ctx *ctx = &ctxs[bt_conn_index(conn)];
+
+    return (ctx->conn == conn) ? ctx : NULL;
+}
+
+static void history_add(struct conn_params_ctx *ctx, conn_params_evt_t evt,
+                        uint16_t interval, uint16_t latency, uint16_t timeout)
+{
+    struct conn_params_record *rec = &ctx->history[ctx->history_head];
+
+    rec->uptime_ms = k_uptime_get_32();
+    rec->interval  = interval;
+    rec->latency   = latency;
+    rec->timeout   = timeout;
+    rec->profile   = ctx->target;
+    rec->event     = evt;
+
+    ctx->history_head = (ctx->history_head + 1) % CONN_PARAMS_HISTORY_LEN;
+    if (ctx->history_count < CONN_PARAMS_HISTORY_LEN) {
+        ctx->history_count++;
+    }
+}
+
+/* Supervision timeout must exceed (1 + latency) * interval_max * 2 */
+static uint16_t min_valid_timeout(const struct bt_le_conn_param *p)
+{
+    return (uint16_t)MIN(((1U + p->latency) * p->interval_max) / 4U + 1U,
+                         CONN_PARAMS_TIMEOUT_MAX);
+}
+
+/* Rejected requests are retried with a wider interval window so that
+ * centrals with coarse scheduling (iOS, Android power savers) can accept. */
+static void widen_request(struct bt_le_conn_param *p)
+{
+    p->interval_max = MIN(p->interval_max + MAX(p->interval_max / 2U, 1U),
+                          CONN_PARAMS_INTERVAL_MAX);
+    p->timeout = MAX(p->timeout, min_valid_timeout(p));
+}
+
+static bool params_match(const struct bt_le_conn_param *req,
+                         uint16_t interval, uint16_t latency)
+{
+    return interval >= req->interval_min &&
+           interval <= req->interval_max &&
+           latency  <= req->latency;
+}
+
+/* Must be called with conn_params_mutex held */
+static void request_send(struct conn_params_ctx *ctx)
+{
+    int err = bt_conn_le_param_update(ctx->conn, &ctx->requested);
+
+    history_add(ctx, CONN_PARAMS_EVT_REQUESTED, ctx->requested.interval_max,
+                ctx->requested.latency, ctx->requested.timeout);
+
+    if (err && err != -EALREADY) {
+        LOG_WRN("Param request failed (err %d)", err);
+        history_add(ctx, CONN_PARAMS_EVT_REJECTED, ctx->requested.interval_max,
+                    ctx->requested.latency, ctx->requested.timeout);
+        ctx->pending = false;
+        if (ctx->retries++ < CONN_PARAMS_MAX_RETRIES) {
+            k_work_reschedule(&ctx->request_work,
+                              K_MSEC(CONN_PARAMS_RETRY_BASE_MS << ctx->retries));
+        }
+        return;
+    }
+
+    if (err == -EALREADY) {
+        /* Link is already inside the requested window */
+        ctx->pending = false;
+        ctx->active  = ctx->target;
+        history_add(ctx, CONN_PARAMS_EVT_APPLIED, ctx->requested.interval_max,
+                    ctx->requested.latency, ctx->requested.timeout);
+        return;
+    }
+
+    ctx->pending = true;
+    k_work_reschedule(&ctx->response_work, K_MSEC(CONN_PARAMS_RESPONSE_MS));
+}
+
+/* Must be called with conn_params_mutex held */
+static void profile_set(struct conn_params_ctx *ctx, conn_params_profile_t profile)
+{
+    if (ctx->target == profile && (ctx->pending || ctx->active == profile)) {
+        return;
+    }
+
+    ctx->target    = profile;
+    ctx->retries   = 0;
+    ctx->requested = profile_params[profile];
+    k_work_cancel_delayable(&ctx->request_work);
+    request_send(ctx);
+}
+
+static void idle_work_handler(struct k_work *work)
+{
+    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+    struct conn_params_ctx *ctx = CONTAINER_OF(dwork, struct conn_params_ctx, idle_work);
+
+    k_mutex_lock(&conn_params_mutex, K_FOREVER);
+    if (ctx->conn) {
+        profile_set(ctx, CONN_PARAMS_PROFILE_IDLE);
+    }
+    k_mutex_unlock(&conn_params_mutex);
+}
+
+static void request_work_handler(struct k_work *work)
+{
+    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+    struct conn_params_ctx *ctx = CONTAINER_OF(dwork, struct conn_params_ctx, request_work);
+
+    k_mutex_lock(&conn_params_mutex, K_FOREVER);
+    if (ctx->conn) {
+        request_send(ctx);
+    }
+    k_mutex_unlock(&conn_params_mutex);
+}
+
+/* The central neither applied nor refused within the response window.
+ * Zephyr doesn't surface L2CAP/LL rejects to the app, so silence is a reject. */
+static void response_work_handler(struct k_work *work)
+{
+    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+    struct conn_params_ctx *ctx = CONTAINER_OF(dwork, struct conn_params_ctx, response_work);
+
+    k_mutex_lock(&conn_params_mutex, K_FOREVER);
+    if (ctx->conn && ctx->pending) {
+        ctx->pending = false;
+        history_add(ctx, CONN_PARAMS_EVT_REJECTED, ctx->requested.interval_max,
+                    ctx->requested.latency, ctx->requested.timeout);
+
+        if (ctx->retries++ < CONN_PARAMS_MAX_RETRIES) {
+            widen_request(&ctx->requested);
+            LOG_WRN("%s params rejected, retry %u with max interval %u",
+                   profile_names[ctx->target], ctx->retries,
+                   ctx->requested.interval_max);
+            k_work_reschedule(&ctx->request_work,
+                              K_MSEC(CONN_PARAMS_RETRY_BASE_MS << ctx->retries));
+        } else {
+            LOG_WRN("%s params rejected, keeping central's choice",
+                   profile_names[ctx->target]);
+        }
+    }
+    k_mutex_unlock(&conn_params_mutex);
+}
+
+/* --------------------------------------------------------------------------
+ * Connection Callbacks
+ * -------------------------------------------------------------------------- */
+static void cp_connected(struct bt_conn *conn, uint8_t err)
+{
+    struct bt_conn_info info;
+
+    if (err || bt_conn_get_info(conn, &info) || info.role != BT_CONN_ROLE_PERIPHERAL) {
+        return;
+    }
+
+    k_mutex_lock(&conn_params_mutex, K_FOREVER);
+    struct conn_params_ctx *ctx = &ctxs[bt_conn_index(conn)];
+
+    ctx->conn          = conn;
+    ctx->target        = CONN_PARAMS_PROFILE_NONE;
+    ctx->active        = CONN_PARAMS_PROFILE_NONE;
+    ctx->pending       = false;
+    ctx->history_head  = 0;
+    ctx->history_count = 0;
+    history_add(ctx, CONN_PARAMS_EVT_PEER_UPDATE, info.le.interval,
+                info.le.latency, info.le.timeout);
+
+    /* Security setup starts right away, so go fast from the first event */
+    profile_set(ctx, CONN_PARAMS_PROFILE_FAST);
+    k_work_reschedule(&ctx->idle_work, K_MSEC(CONFIG_APP_CONN_PARAMS_IDLE_TIMEOUT_MS));
+    k_mutex_unlock(&conn_params_mutex);
+}
+
+static void cp_disconnected(struct bt_conn *conn, uint8_t reason)
+{
+    conn_params_history_print(conn);
+
+    k_mutex_lock(&conn_params_mutex, K_FOREVER);
+    struct conn_params_ctx *ctx = ctx_get(conn);
+
+    if (ctx) {
+        k_work_cancel_delayable(&ctx->idle_work);
+        k_work_cancel_delayable(&ctx->request_work);
+        k_work_cancel_delayable(&ctx->response_work);
+        ctx->conn = NULL;
+    }
+    k_mutex_unlock(&conn_params_mutex);
+}
+
+static bool cp_le_param_req(struct bt_conn *conn, struct bt_le_conn_param *param)
+{
+    /* Accept the central's own requests, the policy re-asserts on next activity */
+    return true;
+}
+
+static void cp_le_param_updated(struct bt_conn *conn, uint16_t interval,
+                                uint16_t latency, uint16_t timeout)
+{
+    k_mutex_lock(&conn_params_mutex, K_FOREVER);
+    struct conn_params_ctx *ctx = ctx_get(conn);
+
+    if (!ctx) {
+        k_mutex_unlock(&conn_params_mutex);
+        return;
+    }
+
+    if (ctx->pending && params_match(&ctx->requested, interval, latency)) {
+        k_work_cancel_delayable(&ctx->response_work);
+        ctx->pending = false;
+        ctx->active  = ctx->target;
+        history_add(ctx, CONN_PARAMS_EVT_APPLIED, interval, latency, timeout);
+        LOG_INF("%s params: interval %u.%02u ms, latency %u, timeout %u ms",
+               profile_names[ctx->active], (interval * 125U) / 100U,
+               (interval * 125U) % 100U, latency, timeout * 10U);
+    } else {
+        ctx->active = CONN_PARAMS_PROFILE_NONE;
+        history_add(ctx, CONN_PARAMS_EVT_PEER_UPDATE, interval, latency, timeout);
+    }
+    k_mutex_unlock(&conn_params_mutex);
+}
+
+static void cp_security_changed(struct bt_conn *conn, bt_security_t level,
+                                enum bt_security_err err)
+{
+    /* Pairing done (or failed): restart the idle countdown from here */
+    conn_params_activity(conn);
+}
+
+BT_CONN_CB_DEFINE(conn_params_callbacks) = {
+    .connected        = cp_connected,
+    .disconnected     = cp_disconnected,
+    .le_param_req     = cp_le_param_req,
+    .le_param_updated = cp_le_param_updated,
+    .security_changed = cp_security_changed,
+};
+
+static int conn_params_sys_init(void)
+{
+    for (size_t i = 0; i < ARRAY_SIZE(ctxs); i++) {
+        k_work_init_delayable(&ctxs[i].idle_work, idle_work_handler);
+        k_work_init_delayable(&ctxs[i].request_work, request_work_handler);
+        k_work_init_delayable(&ctxs[i].response_work, response_work_handler);
+    }
+    return 0;
+}
+
+SYS_INIT(conn_params_sys_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+/* --------------------------------------------------------------------------
+ * Public Functions
+ * -------------------------------------------------------------------------- */
+void conn_params_activity(struct bt_conn *conn)
+{
+    k_mutex_lock(&conn_params_mutex, K_FOREVER);
+    struct conn_params_ctx *ctx = ctx_get(conn);
+
+    if (ctx) {
+        profile_set(ctx, CONN_PARAMS_PROFILE_FAST);
+        k_work_reschedule(&ctx->idle_work,
+                          K_MSEC(CONFIG_APP_CONN_PARAMS_IDLE_TIMEOUT_MS));
+    }
+    k_mutex_unlock(&conn_params_mutex);
+}
+
+size_t conn_params_history_get(struct bt_conn *conn,
+                               struct conn_params_record *out, size_t max)
+{
+    size_t n = 0;
+
+    k_mutex_lock(&conn_params_mutex, K_FOREVER);
+    struct conn_params_ctx *ctx = ctx_get(conn);
+
+    if (ctx) {
+        size_t first = (ctx->history_head + CONN_PARAMS_HISTORY_LEN -
+                        ctx->history_count) % CONN_PARAMS_HISTORY_LEN;
+
+        n = MIN(max, ctx->history_count);
+        for (size_t i = 0; i < n; i++) {
+            out[i] = ctx->history[(first + i) % CONN_PARAMS_HISTORY_LEN];
+        }
+    }
+    k_mutex_unlock(&conn_params_mutex);
+
+    return n;
+}
+
+void conn_params_history_print(struct bt_conn *conn)
+{
+    struct conn_params_record recs[CONN_PARAMS_HISTORY_LEN];
+    size_t n = conn_params_history_get(conn, recs, ARRAY_SIZE(recs));
+
+    LOG_DBG("Param history (%u entries)", (unsigned int)n);
+    for (size_t i = 0; i < n; i++) {
+        LOG_DBG("  %8u ms  %-11s %-7s int %4u lat %2u to %4u",
+               recs[i].uptime_ms, evt_names[recs[i].event],
+               profile_names[recs[i].profile], recs[i].interval,
+               recs[i].latency, recs[i].timeout);
+    }
+}
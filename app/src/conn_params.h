@@ -0,0 +1,76 @@
+/**
+ * @file conn_params.h
+ * @brief Connection parameter policy for the peripheral link
+ *
+ * Requests a short connection interval while security is being set up or
+ * data is moving, then relaxes to a long interval with peripheral latency
+ * once the link has been idle for CONFIG_APP_CONN_PARAMS_IDLE_TIMEOUT_MS.
+ * Connections are picked up automatically through the connection callbacks.
+ */
+
+#ifndef CONN_PARAMS_H
+#define CONN_PARAMS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <zephyr/bluetooth/conn.h>
+
+/* --------------------------------------------------------------------------
+ * Types
+ * -------------------------------------------------------------------------- */
+typedef enum {
+    CONN_PARAMS_PROFILE_NONE = 0, /* whatever the central picked */
+    CONN_PARAMS_PROFILE_FAST,
+    CONN_PARAMS_PROFILE_IDLE,
+} conn_params_profile_t;
+
+typedef enum {
+    CONN_PARAMS_EVT_REQUESTED = 0, /* we asked the central for new params */
+    CONN_PARAMS_EVT_APPLIED,       /* link params now match what we asked */
+    CONN_PARAMS_EVT_REJECTED,      /* request failed, timed out or ignored */
+    CONN_PARAMS_EVT_PEER_UPDATE,   /* central changed params on its own */
+} conn_params_evt_t;
+
+/* One entry of the per-connection parameter history */
+struct conn_params_record {
+    uint32_t uptime_ms;
+    uint16_t interval; /* units of 1.25 ms */
+    uint16_t latency;  /* connection events */
+    uint16_t timeout;  /* units of 10 ms */
+    uint8_t  profile;  /* conn_params_profile_t */
+    uint8_t  event;    /* conn_params_evt_t */
+};
+
+/* --------------------------------------------------------------------------
+ * Public Functions
+ * -------------------------------------------------------------------------- */
+/**
+ * @brief Mark the link as busy (security setup, GATT transfer, ...)
+ *
+ * Switches to the fast profile if needed and restarts the idle timer.
+ *
+ * @param [in] conn The busy connection
+ */
+void conn_params_activity(struct bt_conn *conn);
+
+/**
+ * @brief Copy the parameter history of a connection, oldest entry first
+ *
+ * @param [in]  conn The connection to query
+ * @param [out] out  Destination array
+ * @param [in]  max  Number of entries out can hold
+ *
+ * @return Number of entries copied
+ */
+size_t conn_params_history_get(struct bt_conn *conn,
+                               struct conn_params_record *out, size_t max);
+
+/**
+ * @brief Log the parameter history of a connection at debug level
+ *
+ * @param [in] conn The connection to print
+ */
+void conn_params_history_print(struct bt_conn *conn);
+
+#endif /* CONN_PARAMS_H */
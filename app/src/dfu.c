@@ -0,0 +1,203 @@
+/**
+ * @file dfu.c
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/mgmt/mcumgr/mgmt/callbacks.h>
+#include <zephyr/mgmt/mcumgr/grp/img_mgmt/img_mgmt.h>
+
+#ifdef CONFIG_BOOTLOADER_MCUBOOT
+#include <zephyr/dfu/mcuboot.h>
+#endif
+
+#ifdef CONFIG_SHELL
+#include <zephyr/shell/shell.h>
+#endif
+
+#include "dfu.h"
+#include "events.h"
+
+#ifdef CONFIG_APP_CONN_PARAMS
+#include "conn_params.h"
+#endif
+
+LOG_MODULE_REGISTER(dfu, CONFIG_APP_LOG_LEVEL);
+
+/* --------------------------------------------------------------------------
+ * Global States
+ * -------------------------------------------------------------------------- */
+/* Hooks run on the MCUmgr workqueue, stats are read from the shell thread */
+static struct k_spinlock dfu_lock;
+static struct dfu_stats  dfu_stats;
+static uint32_t          dfu_start_ms;
+static uint8_t           dfu_pct;     /* last published progress */
+
+/* --------------------------------------------------------------------------
+ * Private Functions
+ * -------------------------------------------------------------------------- */
+static void dfu_publish(dfu_evt_type_t type, uint32_t offset, uint32_t size)
+{
+    struct dfu_evt evt = {.type = type, .offset = offset, .size = size};
+
+    evt_publish(&dfu_chan, &evt);
+}
+
+#ifdef CONFIG_APP_CONN_PARAMS
+/* SMP writes bypass the GATT callbacks in main.c, so keep the link on the
+ * fast interval from here while chunks arrive */
+static void dfu_conn_activity(struct bt_conn *conn, void *user_data)
+{
+    conn_params_activity(conn);
+}
+#endif
+
+static void dfu_chunk(const struct img_mgmt_upload_check *chk)
+{
+    uint32_t size = (uint32_t)chk->action->size;
+    uint32_t end  = (uint32_t)chk->req->off + chk->req->img_data.len;
+    bool first    = (chk->req->off == 0);
+    k_spinlock_key_t key = k_spin_lock(&dfu_lock);
+
+    if (first) {
+        dfu_stats.uploads++;
+        dfu_stats.chunks    = 0;
+        dfu_stats.chunk_max = 0;
+        dfu_stats.size      = size;
+        dfu_start_ms        = k_uptime_get_32();
+        dfu_pct             = 0;
+    }
+    dfu_stats.chunks++;
+    dfu_stats.chunk_max = MAX(dfu_stats.chunk_max, chk->req->img_data.len);
+    dfu_stats.bytes     = end;
+
+    uint8_t pct = size ? (uint8_t)(((uint64_t)end * 100U) / size) : 0U;
+    bool progressed = (pct != dfu_pct);
+
+    dfu_pct = pct;
+    k_spin_unlock(&dfu_lock, key);
+
+#ifdef CONFIG_APP_CONN_PARAMS
+    bt_conn_foreach(BT_CONN_TYPE_LE, dfu_conn_activity, NULL);
+#endif
+    if (first) {
+        LOG_INF("[DFU] Upload of %u bytes started", size);
+        dfu_publish(DFU_EVT_STARTED, end, size);
+    } else if (progressed) {
+        dfu_publish(DFU_EVT_PROGRESS, end, size);
+    }
+}
+
+static void dfu_done(bool ok)
+{
+    k_spinlock_key_t key = k_spin_lock(&dfu_lock);
+    uint32_t bytes = dfu_stats.bytes;
+    uint32_t size  = dfu_stats.size;
+
+    if (ok) {
+        dfu_stats.completed++;
+        dfu_stats.last_ms = k_uptime_get_32() - dfu_start_ms;
+    } else {
+        dfu_stats.failed++;
+    }
+    uint32_t ms = dfu_stats.last_ms;
+
+    k_spin_unlock(&dfu_lock, key);
+
+    if (ok) {
+        LOG_INF("[DFU] Image of %u bytes received in %u ms, reset to apply", size, ms);
+        dfu_publish(DFU_EVT_DONE, bytes, size);
+    } else {
+        LOG_WRN("[DFU] Upload stopped at %u of %u bytes", bytes, size);
+        dfu_publish(DFU_EVT_FAILED, bytes, size);
+    }
+}
+
+static enum mgmt_cb_return dfu_mgmt_cb(uint32_t event, enum mgmt_cb_return prev_status,
+                                       int32_t *rc, uint16_t *group, bool *abort_more,
+                                       void *data, size_t data_size)
+{
+    switch (event) {
+    case MGMT_EVT_OP_IMG_MGMT_DFU_CHUNK:
+        /* Runs before the chunk is checked and written: a rejected chunk
+         * is followed by DFU_STOPPED */
+        if (prev_status == MGMT_CB_OK) {
+            dfu_chunk(data);
+        }
+        break;
+    case MGMT_EVT_OP_IMG_MGMT_DFU_PENDING:
+        dfu_done(true);
+        break;
+    case MGMT_EVT_OP_IMG_MGMT_DFU_STOPPED:
+        dfu_done(false);
+        break;
+    default:
+        break;
+    }
+    return MGMT_CB_OK;
+}
+
+static struct mgmt_callback dfu_mgmt_callback = {
+    .callback = dfu_mgmt_cb,
+    .event_id = MGMT_EVT_OP_IMG_MGMT_DFU_CHUNK | MGMT_EVT_OP_IMG_MGMT_DFU_PENDING |
+                MGMT_EVT_OP_IMG_MGMT_DFU_STOPPED,
+};
+
+/* --------------------------------------------------------------------------
+ * Public Functions
+ * -------------------------------------------------------------------------- */
+int dfu_init(void)
+{
+#ifdef CONFIG_BOOTLOADER_MCUBOOT
+    /* First boot after a test swap: keep the image now that it works */
+    if (!boot_is_img_confirmed()) {
+        int err = boot_write_img_confirmed();
+
+        if (err) {
+            LOG_ERR("[DFU] Image confirm failed (err %d)", err);
+            return err;
+        }
+        LOG_INF("[DFU] New image confirmed");
+    }
+#endif
+    mgmt_callback_register(&dfu_mgmt_callback);
+    return 0;
+}
+
+void dfu_stats_get(struct dfu_stats *out)
+{
+    k_spinlock_key_t key = k_spin_lock(&dfu_lock);
+
+    *out = dfu_stats;
+    k_spin_unlock(&dfu_lock, key);
+}
+
+/* --------------------------------------------------------------------------
+ * Shell Commands
+ * -------------------------------------------------------------------------- */
+#ifdef CONFIG_SHELL
+static int cmd_dfu_stats(const struct shell *sh, size_t argc, char **argv)
+{
+    struct dfu_stats st;
+
+    dfu_stats_get(&st);
+    shell_print(sh, "%u uploads, %u completed, %u failed", st.uploads, st.completed,
+                st.failed);
+    shell_print(sh, "Last: %u/%u bytes in %u chunks (max %u bytes)", st.bytes, st.size,
+                st.chunks, st.chunk_max);
+    if (st.completed) {
+        shell_print(sh, "Last completed upload took %u ms (%u B/s)", st.last_ms,
+                    st.last_ms ? (uint32_t)(((uint64_t)st.size * MSEC_PER_SEC) / st.last_ms)
+                               : 0U);
+    }
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(dfu_cmds,
+    SHELL_CMD(stats, NULL, "Image uploads, chunk sizes and duration", cmd_dfu_stats),
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(dfu, &dfu_cmds, "Firmware update over BLE", NULL);
+#endif /* CONFIG_SHELL */
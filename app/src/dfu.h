@@ -0,0 +1,54 @@
+/**
+ * @file dfu.h
+ * @brief Firmware update over BLE: MCUmgr image upload into MCUboot's
+ *        secondary slot
+ *
+ * The SMP service itself is MCUmgr's and only accepts requests on an
+ * encrypted, authenticated (passkey) link. Image chunks are streamed to the
+ * secondary slot through a page-sized buffer, erasing each page just before
+ * it is written. This module follows uploads through the MCUmgr hooks,
+ * publishes progress on dfu_chan, keeps the link on the fast connection
+ * interval while chunks arrive and confirms a freshly swapped image once it
+ * has brought Bluetooth up.
+ */
+
+#ifndef DFU_H
+#define DFU_H
+
+#include <stdint.h>
+
+/* --------------------------------------------------------------------------
+ * Types
+ * -------------------------------------------------------------------------- */
+struct dfu_stats {
+    uint32_t uploads;     /* started */
+    uint32_t completed;
+    uint32_t failed;
+    uint32_t chunks;      /* of the current or last upload */
+    uint32_t chunk_max;   /* largest chunk, bytes */
+    uint32_t bytes;       /* received in the current or last upload */
+    uint32_t size;        /* image size of the current or last upload */
+    uint32_t last_ms;     /* first to last chunk of the last completed upload */
+};
+
+/* --------------------------------------------------------------------------
+ * Public Functions
+ * -------------------------------------------------------------------------- */
+/**
+ * @brief Start following uploads, confirm the running image if it is new
+ *
+ * Call once Bluetooth is up: an image that got this far is kept, otherwise
+ * MCUboot reverts to the previous one on the next reset.
+ *
+ * @return Error code, < 0 on failures
+ */
+int dfu_init(void);
+
+/**
+ * @brief Get the upload statistics
+ *
+ * @param [out] out Statistics
+ */
+void dfu_stats_get(struct dfu_stats *out);
+
+#endif /* DFU_H */
@@ -0,0 +1,165 @@
+/**
+ * @file events.c
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/zbus/zbus.h>
+
+#ifdef CONFIG_SHELL
+#include <zephyr/shell/shell.h>
+#endif
+
+#include "events.h"
+
+LOG_MODULE_REGISTER(events, CONFIG_APP_LOG_LEVEL);
+
+/* --------------------------------------------------------------------------
+ * Constants
+ * -------------------------------------------------------------------------- */
+#define EVT_PUB_TIMEOUT K_MSEC(CONFIG_APP_EVT_PUB_TIMEOUT_MS)
+
+/* --------------------------------------------------------------------------
+ * Channels
+ * -------------------------------------------------------------------------- */
+static struct evt_chan_stats conn_chan_stats = {.lat_min_us = UINT32_MAX};
+static struct evt_chan_stats sec_chan_stats  = {.lat_min_us = UINT32_MAX};
+static struct evt_chan_stats btn_chan_stats  = {.lat_min_us = UINT32_MAX};
+static struct evt_chan_stats ui_chan_stats   = {.lat_min_us = UINT32_MAX};
+static struct evt_chan_stats pwr_chan_stats  = {.lat_min_us = UINT32_MAX};
+static struct evt_chan_stats dfu_chan_stats  = {.lat_min_us = UINT32_MAX};
+
+/* Observers attach themselves with ZBUS_CHAN_ADD_OBS() next to their code */
+ZBUS_CHAN_DEFINE(conn_chan, struct conn_evt, NULL, &conn_chan_stats,
+                 ZBUS_OBSERVERS_EMPTY, ZBUS_MSG_INIT(0));
+ZBUS_CHAN_DEFINE(sec_chan, struct sec_evt, NULL, &sec_chan_stats,
+                 ZBUS_OBSERVERS_EMPTY, ZBUS_MSG_INIT(0));
+ZBUS_CHAN_DEFINE(btn_chan, struct btn_evt, NULL, &btn_chan_stats,
+                 ZBUS_OBSERVERS_EMPTY, ZBUS_MSG_INIT(0));
+ZBUS_CHAN_DEFINE(ui_chan, struct ui_evt, NULL, &ui_chan_stats,
+                 ZBUS_OBSERVERS_EMPTY, ZBUS_MSG_INIT(0));
+ZBUS_CHAN_DEFINE(pwr_chan, struct pwr_evt, NULL, &pwr_chan_stats,
+                 ZBUS_OBSERVERS_EMPTY, ZBUS_MSG_INIT(0));
+ZBUS_CHAN_DEFINE(dfu_chan, struct dfu_evt, NULL, &dfu_chan_stats,
+                 ZBUS_OBSERVERS_EMPTY, ZBUS_MSG_INIT(0));
+
+static struct k_spinlock stats_lock;
+
+/* Message subscribers get a copy of each message from a static pool */
+#ifdef CONFIG_ZBUS_MSG_SUBSCRIBER_BUF_ALLOC_STATIC
+BUILD_ASSERT(sizeof(struct conn_evt) <= CONFIG_ZBUS_MSG_SUBSCRIBER_NET_BUF_STATIC_DATA_SIZE &&
+             sizeof(struct sec_evt) <= CONFIG_ZBUS_MSG_SUBSCRIBER_NET_BUF_STATIC_DATA_SIZE &&
+             sizeof(struct btn_evt) <= CONFIG_ZBUS_MSG_SUBSCRIBER_NET_BUF_STATIC_DATA_SIZE &&
+             sizeof(struct ui_evt) <= CONFIG_ZBUS_MSG_SUBSCRIBER_NET_BUF_STATIC_DATA_SIZE &&
+             sizeof(struct pwr_evt) <= CONFIG_ZBUS_MSG_SUBSCRIBER_NET_BUF_STATIC_DATA_SIZE &&
+             sizeof(struct dfu_evt) <= CONFIG_ZBUS_MSG_SUBSCRIBER_NET_BUF_STATIC_DATA_SIZE,
+             "ZBUS_MSG_SUBSCRIBER_NET_BUF_STATIC_DATA_SIZE too small for the event messages");
+#endif
+
+/* --------------------------------------------------------------------------
+ * Public Functions
+ * -------------------------------------------------------------------------- */
+int evt_publish(const struct zbus_channel *chan, void *msg)
+{
+    struct evt_chan_stats *st = zbus_chan_user_data(chan);
+    k_spinlock_key_t key;
+
+    ((struct evt_hdr *)msg)->pub_cycles = k_cycle_get_32();
+
+    /* Counted before publishing: a higher-priority subscriber may take the
+     * message before zbus_chan_pub() returns */
+    key = k_spin_lock(&stats_lock);
+    st->published++;
+    k_spin_unlock(&stats_lock, key);
+
+    int err = zbus_chan_pub(chan, msg, EVT_PUB_TIMEOUT);
+
+    if (err) {
+        key = k_spin_lock(&stats_lock);
+        st->published--;
+        st->pub_failed++;
+        k_spin_unlock(&stats_lock, key);
+        LOG_WRN("Publish on %s failed (err %d)", zbus_chan_name(chan), err);
+    }
+    return err;
+}
+
+int evt_wait(const struct zbus_observer *obs, const struct zbus_channel **chan, void *msg,
+             k_timeout_t timeout)
+{
+    int err = zbus_sub_wait_msg(obs, chan, msg, timeout);
+
+    if (err) {
+        return err;
+    }
+
+    struct evt_chan_stats *st = zbus_chan_user_data(*chan);
+    uint32_t lat_us = k_cyc_to_us_floor32(k_cycle_get_32() -
+                                          ((struct evt_hdr *)msg)->pub_cycles);
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+    /* published - delivered is one subscriber's backlog only while the
+     * channel has a single message subscriber */
+    if (!st->sub) {
+        st->sub = obs;
+    }
+    __ASSERT(st->sub == obs, "%s has a second message subscriber, queue depth is per channel",
+             zbus_chan_name(*chan));
+
+    /* This message plus those of the channel still queued behind it */
+    uint32_t depth = st->published - st->delivered;
+
+    st->delivered++;
+    st->lat_min_us  = MIN(st->lat_min_us, lat_us);
+    st->lat_max_us  = MAX(st->lat_max_us, lat_us);
+    st->lat_sum_us += lat_us;
+    st->queue_max   = MAX(st->queue_max, MIN(depth, UINT8_MAX));
+    k_spin_unlock(&stats_lock, key);
+
+    return 0;
+}
+
+void evt_stats_get(const struct zbus_channel *chan, struct evt_chan_stats *out)
+{
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+    *out = *(struct evt_chan_stats *)zbus_chan_user_data(chan);
+    k_spin_unlock(&stats_lock, key);
+
+    if (!out->delivered) {
+        out->lat_min_us = 0;
+    }
+}
+
+/* --------------------------------------------------------------------------
+ * Shell Commands
+ * -------------------------------------------------------------------------- */
+#ifdef CONFIG_SHELL
+static int cmd_evt_stats(const struct shell *sh, size_t argc, char **argv)
+{
+    static const struct zbus_channel *const chans[] = {
+        &conn_chan, &sec_chan, &btn_chan, &ui_chan, &pwr_chan, &dfu_chan,
+    };
+
+    shell_print(sh, "%-10s %6s %5s %6s %8s %8s %8s %5s", "channel", "pub",
+                "fail", "deliv", "min[us]", "avg[us]", "max[us]", "qmax");
+    for (size_t i = 0; i < ARRAY_SIZE(chans); i++) {
+        struct evt_chan_stats st;
+
+        evt_stats_get(chans[i], &st);
+        shell_print(sh, "%-10s %6u %5u %6u %8u %8u %8u %5u",
+                    zbus_chan_name(chans[i]), st.published, st.pub_failed,
+                    st.delivered, st.lat_min_us,
+                    st.delivered ? (uint32_t)(st.lat_sum_us / st.delivered) : 0U,
+                    st.lat_max_us, st.queue_max);
+    }
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(evt_cmds,
+    SHELL_CMD(stats, NULL, "Per-channel delivery latency and queue depth", cmd_evt_stats),
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(evt, &evt_cmds, "Event bus", NULL);
+#endif /* CONFIG_SHELL */
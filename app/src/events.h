@@ -0,0 +1,143 @@
+/**
+ * @file events.h
+ * @brief Typed zbus channels connecting BLE, buttons, LEDs, power and the UI
+ *
+ * Every message starts with an evt_hdr carrying the publish timestamp so
+ * subscribers can report publish-to-delivery latency per channel.
+ * Subscribers are message subscribers: each gets its own copy of every
+ * message, in publish order, from zbus' static buffer pool, so back-to-back
+ * publishes on one channel (e.g. LEVEL_CHANGED then PAIRED) are all seen.
+ */
+
+#ifndef EVENTS_H
+#define EVENTS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/zbus/zbus.h>
+#include <zephyr/bluetooth/addr.h>
+
+/* --------------------------------------------------------------------------
+ * Types
+ * -------------------------------------------------------------------------- */
+struct evt_hdr {
+    uint32_t pub_cycles; /* k_cycle_get_32() at publish */
+};
+
+typedef enum {
+    CONN_EVT_CONNECTED = 0,
+    CONN_EVT_DISCONNECTED,
+} conn_evt_type_t;
+
+struct conn_evt {
+    struct evt_hdr  hdr;
+    conn_evt_type_t type;
+    uint8_t         reason; /* HCI reason, disconnect only */
+    bt_addr_le_t    peer;
+};
+
+typedef enum {
+    SEC_EVT_PASSKEY = 0,   /* passkey shown to the user */
+    SEC_EVT_LEVEL_CHANGED, /* link encryption level changed */
+    SEC_EVT_PAIRED,
+    SEC_EVT_FAILED,        /* pairing failed, published once per attempt */
+} sec_evt_type_t;
+
+struct sec_evt {
+    struct evt_hdr hdr;
+    sec_evt_type_t type;
+    uint32_t       passkey; /* SEC_EVT_PASSKEY only */
+    uint8_t        level;   /* SEC_EVT_LEVEL_CHANGED only */
+    uint8_t        err;     /* bt_security_err, 0 on success */
+    bool           bonded;  /* SEC_EVT_PAIRED only */
+};
+
+struct btn_evt {
+    struct evt_hdr hdr;
+    uint8_t        btn;     /* btn_id */
+};
+
+/* Published by the UI after it switched state */
+struct ui_evt {
+    struct evt_hdr hdr;
+    uint8_t        state;   /* ui_state_t */
+};
+
+/* Published by the power manager after it switched state */
+struct pwr_evt {
+    struct evt_hdr hdr;
+    uint8_t        state;   /* pwr_state_t */
+};
+
+typedef enum {
+    DFU_EVT_STARTED = 0,   /* first chunk of an image accepted */
+    DFU_EVT_PROGRESS,
+    DFU_EVT_DONE,          /* whole image in the secondary slot */
+    DFU_EVT_FAILED,        /* upload stopped or rejected */
+} dfu_evt_type_t;
+
+/* Published by the firmware update module, progress once per percent */
+struct dfu_evt {
+    struct evt_hdr hdr;
+    dfu_evt_type_t type;
+    uint32_t       offset;  /* bytes received */
+    uint32_t       size;    /* image size */
+};
+
+/* Per-channel delivery statistics, kept in the channel's user data. A
+ * channel has at most one message subscriber (listeners don't count), so
+ * delivered and queue_max are that subscriber's. */
+struct evt_chan_stats {
+    uint32_t published;
+    uint32_t pub_failed;
+    uint32_t delivered;
+    uint32_t lat_min_us;
+    uint32_t lat_max_us;
+    uint64_t lat_sum_us;
+    uint8_t  queue_max;    /* most messages of the channel queued at delivery */
+    const struct zbus_observer *sub; /* the message subscriber, set on first delivery */
+};
+
+ZBUS_CHAN_DECLARE(conn_chan, sec_chan, btn_chan, ui_chan, pwr_chan, dfu_chan);
+
+/* --------------------------------------------------------------------------
+ * Public Functions
+ * -------------------------------------------------------------------------- */
+/**
+ * @brief Timestamp and publish a message on a channel
+ *
+ * @param [in] chan The channel to publish on
+ * @param [in] msg  Message of the channel's type, starting with struct evt_hdr
+ *
+ * @return Error code, < 0 on failures
+ */
+int evt_publish(const struct zbus_channel *chan, void *msg);
+
+/**
+ * @brief Wait for the next message of a message subscriber and account its
+ *        delivery latency
+ *
+ * Queue depth is counted per channel, so each channel may have only one
+ * message subscriber calling this; a second one trips an assert.
+ *
+ * @param [in]  obs     Subscriber, defined with ZBUS_MSG_SUBSCRIBER_DEFINE()
+ * @param [out] chan    Channel the message was published on
+ * @param [out] msg     Destination, sized for every message type obs receives
+ * @param [in]  timeout Maximum time to wait
+ *
+ * @return Error code, < 0 on failures (-EAGAIN on timeout)
+ */
+int evt_wait(const struct zbus_observer *obs, const struct zbus_channel **chan, void *msg,
+             k_timeout_t timeout);
+
+/**
+ * @brief Copy the delivery statistics of a channel
+ *
+ * @param [in]  chan The channel to query
+ * @param [out] out  Destination
+ */
+void evt_stats_get(const struct zbus_channel *chan, struct evt_chan_stats *out);
+
+#endif /* EVENTS_H */
@@ -0,0 +1,183 @@
+/**
+ * @file evt_replay.c
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/gpio/gpio_emul.h>
+
+#include "BTN.h"
+
+#include "events.h"
+#include "evt_trace.h"
+
+LOG_MODULE_REGISTER(evt_replay, CONFIG_APP_LOG_LEVEL);
+
+/* --------------------------------------------------------------------------
+ * Constants
+ * -------------------------------------------------------------------------- */
+#define REPLAY_HOLD K_MSEC(CONFIG_APP_EVT_REPLAY_HOLD_MS)
+
+/* --------------------------------------------------------------------------
+ * Global States
+ * -------------------------------------------------------------------------- */
+/* The pins BTN reads, driven through the GPIO emulator */
+static const struct gpio_dt_spec replay_btns[NUM_BTNS] = {
+    GPIO_DT_SPEC_GET(DT_ALIAS(sw0), gpios),
+    GPIO_DT_SPEC_GET(DT_ALIAS(sw1), gpios),
+    GPIO_DT_SPEC_GET(DT_ALIAS(sw2), gpios),
+    GPIO_DT_SPEC_GET(DT_ALIAS(sw3), gpios),
+};
+
+static struct k_work_delayable replay_release[NUM_BTNS];
+
+/* --------------------------------------------------------------------------
+ * Private Functions
+ * -------------------------------------------------------------------------- */
+static uint64_t replay_now_us(void)
+{
+    return k_ticks_to_us_floor64(k_uptime_ticks());
+}
+
+static void replay_btn_set(size_t btn, bool active)
+{
+    const struct gpio_dt_spec *spec = &replay_btns[btn];
+    bool active_low = spec->dt_flags & GPIO_ACTIVE_LOW;
+
+    gpio_emul_input_set(spec->port, spec->pin, (active != active_low) ? 1 : 0);
+}
+
+static void replay_release_handler(struct k_work *work)
+{
+    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+
+    replay_btn_set(dwork - replay_release, false);
+}
+
+/* Recorded are press edges only: hold long enough to pass the debounce */
+static int replay_btn(uint8_t btn)
+{
+    if (btn >= NUM_BTNS) {
+        return -EINVAL;
+    }
+    /* Still held from the last press: release first so this is an edge */
+    replay_btn_set(btn, false);
+    replay_btn_set(btn, true);
+    k_work_reschedule(&replay_release[btn], REPLAY_HOLD);
+    return 0;
+}
+
+/* Published like the BT callbacks do. The peer address isn't recorded. */
+static int replay_ble(uint8_t kind, uint8_t type, uint32_t arg)
+{
+    if (kind == EVT_TRACE_CONN) {
+        struct conn_evt evt = {.type = type, .reason = (uint8_t)arg};
+
+        return evt_publish(&conn_chan, &evt);
+    }
+
+    struct sec_evt evt = {.type = type};
+
+    switch (type) {
+    case SEC_EVT_PASSKEY:
+        /* Not recorded, the UI shows 000000 */
+        break;
+    case SEC_EVT_LEVEL_CHANGED:
+        evt.level = arg & 0xFF;
+        evt.err   = (arg >> 8) & 0xFF;
+        break;
+    case SEC_EVT_PAIRED:
+        evt.bonded = arg;
+        break;
+    case SEC_EVT_FAILED:
+        evt.err = arg;
+        break;
+    default:
+        return -EINVAL;
+    }
+    return evt_publish(&sec_chan, &evt);
+}
+
+static int replay_inject(const struct evt_trace_rec *rec)
+{
+    uint8_t kind = rec->kind_type >> 4;
+    uint8_t type = rec->kind_type & 0x0F;
+
+    switch (kind) {
+    case EVT_TRACE_BTN:
+        return replay_btn(type);
+    case EVT_TRACE_CONN:
+    case EVT_TRACE_SEC:
+        return replay_ble(kind, type, sys_get_le24(rec->arg));
+    default:
+        return -EINVAL;
+    }
+}
+
+/* --------------------------------------------------------------------------
+ * Public Functions
+ * -------------------------------------------------------------------------- */
+int evt_trace_replay(const uint8_t *trace, size_t len, uint32_t speedup,
+                     struct evt_replay_stats *stats)
+{
+    const struct evt_trace_hdr *hdr = (const struct evt_trace_hdr *)trace;
+    const struct evt_trace_rec *recs = (const struct evt_trace_rec *)(trace + sizeof(*hdr));
+    struct evt_replay_stats st = {0};
+
+    if (len < sizeof(*hdr) || sys_le32_to_cpu(hdr->magic) != EVT_TRACE_MAGIC ||
+        hdr->version != EVT_TRACE_VERSION || hdr->rec_size != sizeof(struct evt_trace_rec)) {
+        return -EINVAL;
+    }
+
+    uint16_t count = sys_le16_to_cpu(hdr->count);
+
+    if (len < sizeof(*hdr) + count * sizeof(struct evt_trace_rec)) {
+        return -EINVAL;
+    }
+
+    uint64_t start = replay_now_us();
+    uint64_t trace_us = 0;
+
+    for (uint16_t i = 0; i < count; i++) {
+        trace_us += sys_le32_to_cpu(recs[i].dt_us);
+        if (speedup) {
+            uint64_t due = start + trace_us / speedup;
+            uint64_t now = replay_now_us();
+
+            if (due > now) {
+                k_sleep(K_USEC(due - now));
+                now = replay_now_us();
+            }
+            st.lag_max_us = MAX(st.lag_max_us, (uint32_t)MIN(now - due, UINT32_MAX));
+        }
+
+        if (replay_inject(&recs[i])) {
+            st.failed++;
+        } else {
+            st.injected++;
+        }
+    }
+    st.elapsed_us = (uint32_t)MIN(replay_now_us() - start, UINT32_MAX);
+
+    LOG_DBG("Replayed %u events at x%u in %u us (lag max %u us)", st.injected, speedup,
+            st.elapsed_us, st.lag_max_us);
+    if (stats) {
+        *stats = st;
+    }
+    return 0;
+}
+
+/* Before BTN_init() configures the pins: buttons start released */
+static int evt_replay_init(void)
+{
+    for (size_t i = 0; i < NUM_BTNS; i++) {
+        k_work_init_delayable(&replay_release[i], replay_release_handler);
+        replay_btn_set(i, false);
+    }
+    return 0;
+}
+
+SYS_INIT(evt_replay_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
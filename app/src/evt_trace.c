@@ -0,0 +1,236 @@
+/**
+ * @file evt_trace.c
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/zbus/zbus.h>
+
+#ifdef CONFIG_SHELL
+#include <zephyr/shell/shell.h>
+#endif
+
+#include "BTN.h"
+
+#include "events.h"
+#include "evt_trace.h"
+
+LOG_MODULE_REGISTER(evt_trace, CONFIG_APP_LOG_LEVEL);
+
+/* --------------------------------------------------------------------------
+ * Constants
+ * -------------------------------------------------------------------------- */
+#define TRACE_LEN      CONFIG_APP_EVT_TRACE_LEN
+#define TRACE_MAX_SIZE (sizeof(struct evt_trace_hdr) + TRACE_LEN * sizeof(struct evt_trace_rec))
+
+/* --------------------------------------------------------------------------
+ * Global States
+ * -------------------------------------------------------------------------- */
+static struct k_spinlock    trace_lock;
+static struct evt_trace_rec trace_ring[TRACE_LEN];
+static size_t               trace_head;  /* next slot written */
+static size_t               trace_count;
+static uint32_t             trace_overwritten;
+static uint64_t             trace_last_us;
+static bool                 trace_on = IS_ENABLED(CONFIG_APP_EVT_TRACE_AUTOSTART);
+
+/* --------------------------------------------------------------------------
+ * Private Functions
+ * -------------------------------------------------------------------------- */
+/* ISR safe: called from the BTN interrupt and from zbus publishers */
+static void trace_put(evt_trace_kind_t kind, uint8_t type, uint32_t arg)
+{
+    uint64_t now = k_ticks_to_us_floor64(k_uptime_ticks());
+    k_spinlock_key_t key = k_spin_lock(&trace_lock);
+
+    if (trace_on) {
+        struct evt_trace_rec *rec = &trace_ring[trace_head];
+        uint64_t dt = trace_count ? (now - trace_last_us) : 0;
+
+        rec->dt_us     = sys_cpu_to_le32((uint32_t)MIN(dt, UINT32_MAX));
+        rec->kind_type = (uint8_t)((kind << 4) | (type & 0x0F));
+        sys_put_le24(arg, rec->arg);
+
+        trace_last_us = now;
+        trace_head = (trace_head + 1) % TRACE_LEN;
+        if (trace_count < TRACE_LEN) {
+            trace_count++;
+        } else {
+            trace_overwritten++;
+        }
+    }
+    k_spin_unlock(&trace_lock, key);
+}
+
+static void trace_btn_edge(btn_id btn)
+{
+    trace_put(EVT_TRACE_BTN, btn, 0);
+}
+
+/* The passkey is a secret and "rec dump" prints the ring, so it isn't kept */
+static uint32_t trace_sec_arg(const struct sec_evt *evt)
+{
+    switch (evt->type) {
+    case SEC_EVT_LEVEL_CHANGED:
+        return evt->level | (evt->err << 8);
+    case SEC_EVT_PAIRED:
+        return evt->bonded;
+    case SEC_EVT_FAILED:
+        return evt->err;
+    default:
+        return 0;
+    }
+}
+
+/* Same events the BT callbacks hand to the rest of the app */
+static void trace_bus_listener(const struct zbus_channel *chan)
+{
+    if (chan == &conn_chan) {
+        const struct conn_evt *evt = zbus_chan_const_msg(chan);
+
+        trace_put(EVT_TRACE_CONN, evt->type, evt->reason);
+    } else if (chan == &sec_chan) {
+        const struct sec_evt *evt = zbus_chan_const_msg(chan);
+
+        trace_put(EVT_TRACE_SEC, evt->type, trace_sec_arg(evt));
+    }
+}
+
+ZBUS_LISTENER_DEFINE(trace_lis, trace_bus_listener);
+ZBUS_CHAN_ADD_OBS(conn_chan, trace_lis, 0);
+ZBUS_CHAN_ADD_OBS(sec_chan, trace_lis, 0);
+
+/* --------------------------------------------------------------------------
+ * Public Functions
+ * -------------------------------------------------------------------------- */
+void evt_trace_start(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&trace_lock);
+
+    trace_on = true;
+    k_spin_unlock(&trace_lock, key);
+}
+
+void evt_trace_stop(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&trace_lock);
+
+    trace_on = false;
+    k_spin_unlock(&trace_lock, key);
+}
+
+void evt_trace_clear(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&trace_lock);
+
+    trace_head        = 0;
+    trace_count       = 0;
+    trace_overwritten = 0;
+    k_spin_unlock(&trace_lock, key);
+}
+
+int evt_trace_export(uint8_t *out, size_t max)
+{
+    struct evt_trace_hdr hdr = {
+        .magic    = sys_cpu_to_le32(EVT_TRACE_MAGIC),
+        .version  = EVT_TRACE_VERSION,
+        .rec_size = sizeof(struct evt_trace_rec),
+    };
+    struct evt_trace_rec *recs = (struct evt_trace_rec *)(out + sizeof(hdr));
+
+    if (max < sizeof(hdr)) {
+        return -ENOMEM;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&trace_lock);
+    /* Newest records if out is too small for all of them */
+    size_t n = MIN(trace_count, (max - sizeof(hdr)) / sizeof(struct evt_trace_rec));
+    size_t first = (trace_head + TRACE_LEN - n) % TRACE_LEN;
+
+    for (size_t i = 0; i < n; i++) {
+        recs[i] = trace_ring[(first + i) % TRACE_LEN];
+    }
+    k_spin_unlock(&trace_lock, key);
+
+    if (n) {
+        recs[0].dt_us = 0;
+    }
+    hdr.count = sys_cpu_to_le16((uint16_t)n);
+    memcpy(out, &hdr, sizeof(hdr));
+    return sizeof(hdr) + n * sizeof(struct evt_trace_rec);
+}
+
+static int evt_trace_init(void)
+{
+    BTN_set_edge_callback(trace_btn_edge);
+    return 0;
+}
+
+SYS_INIT(evt_trace_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+/* --------------------------------------------------------------------------
+ * Shell Commands
+ * -------------------------------------------------------------------------- */
+#ifdef CONFIG_SHELL
+static int cmd_rec_start(const struct shell *sh, size_t argc, char **argv)
+{
+    evt_trace_start();
+    return 0;
+}
+
+static int cmd_rec_stop(const struct shell *sh, size_t argc, char **argv)
+{
+    evt_trace_stop();
+    return 0;
+}
+
+static int cmd_rec_clear(const struct shell *sh, size_t argc, char **argv)
+{
+    evt_trace_clear();
+    return 0;
+}
+
+static int cmd_rec_stats(const struct shell *sh, size_t argc, char **argv)
+{
+    k_spinlock_key_t key = k_spin_lock(&trace_lock);
+    bool on = trace_on;
+    size_t count = trace_count;
+    uint32_t overwritten = trace_overwritten;
+
+    k_spin_unlock(&trace_lock, key);
+    shell_print(sh, "%s, %u/%u records, %u overwritten", on ? "recording" : "stopped",
+                (uint32_t)count, TRACE_LEN, overwritten);
+    return 0;
+}
+
+/* "REC <hex>" lines, turned back into a file by bench/replay/rec2bin.py */
+static int cmd_rec_dump(const struct shell *sh, size_t argc, char **argv)
+{
+    static uint8_t buf[TRACE_MAX_SIZE];
+    int len = evt_trace_export(buf, sizeof(buf));
+
+    for (int i = 0; i < len; i += 32) {
+        char line[2 * 32 + 1];
+        size_t n = MIN(32, len - i);
+
+        bin2hex(&buf[i], n, line, sizeof(line));
+        shell_print(sh, "REC %s", line);
+    }
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(rec_cmds,
+    SHELL_CMD(start, NULL, "Record button and BLE events", cmd_rec_start),
+    SHELL_CMD(stop, NULL, "Stop recording", cmd_rec_stop),
+    SHELL_CMD(clear, NULL, "Forget recorded events", cmd_rec_clear),
+    SHELL_CMD(stats, NULL, "Recorder state", cmd_rec_stats),
+    SHELL_CMD(dump, NULL, "Print the trace as hex", cmd_rec_dump),
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(rec, &rec_cmds, "Event recorder", NULL);
+#endif /* CONFIG_SHELL */
@@ -0,0 +1,102 @@
+/**
+ * @file evt_trace.h
+ * @brief Record and replay of button edges and BLE connection/auth events
+ *
+ * The recorder keeps the most recent CONFIG_APP_EVT_TRACE_LEN inputs: raw
+ * button edges from the BTN interrupt, and the conn_chan/sec_chan events the
+ * BT callbacks publish. An exported trace is an evt_trace_hdr followed by
+ * evt_trace_rec entries, oldest first, all little endian.
+ *
+ * The replayer (CONFIG_APP_EVT_REPLAY, needs the GPIO emulator) drives the
+ * button pins so edges go through the real interrupt and debounce path, and
+ * republishes BLE events the way the BT callbacks do.
+ */
+
+#ifndef EVT_TRACE_H
+#define EVT_TRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <zephyr/toolchain.h>
+
+/* --------------------------------------------------------------------------
+ * Constants
+ * -------------------------------------------------------------------------- */
+#define EVT_TRACE_MAGIC   0x52545645 /* "EVTR" */
+#define EVT_TRACE_VERSION 1
+
+/* --------------------------------------------------------------------------
+ * Types
+ * -------------------------------------------------------------------------- */
+typedef enum {
+    EVT_TRACE_BTN = 0, /* type: btn_id */
+    EVT_TRACE_CONN,    /* type: conn_evt_type_t, arg: disconnect reason */
+    EVT_TRACE_SEC,     /* type: sec_evt_type_t, arg: see evt_trace_rec */
+} evt_trace_kind_t;
+
+struct evt_trace_hdr {
+    uint32_t magic;
+    uint8_t  version;
+    uint8_t  rec_size;  /* sizeof(struct evt_trace_rec) */
+    uint16_t count;     /* records that follow */
+} __packed;
+
+/* SEC arg: level | err << 8 for SEC_EVT_LEVEL_CHANGED, bonded for
+ * SEC_EVT_PAIRED, err for SEC_EVT_FAILED, 0 otherwise. The passkey of
+ * SEC_EVT_PASSKEY isn't recorded. */
+struct evt_trace_rec {
+    uint32_t dt_us;     /* since the previous record, saturating */
+    uint8_t  kind_type; /* evt_trace_kind_t << 4 | type */
+    uint8_t  arg[3];    /* 24 bit, little endian */
+} __packed;
+
+struct evt_replay_stats {
+    uint32_t injected;
+    uint32_t failed;      /* unknown records, publish failures */
+    uint32_t lag_max_us;  /* latest injection behind schedule */
+    uint32_t elapsed_us;
+};
+
+/* --------------------------------------------------------------------------
+ * Public Functions
+ * -------------------------------------------------------------------------- */
+/**
+ * @brief Start recording, keeps what was recorded so far
+ */
+void evt_trace_start(void);
+
+/**
+ * @brief Stop recording
+ */
+void evt_trace_stop(void);
+
+/**
+ * @brief Forget every record
+ */
+void evt_trace_clear(void);
+
+/**
+ * @brief Serialize the recorded trace
+ *
+ * @param [out] out Destination
+ * @param [in]  max Size of out
+ *
+ * @return Bytes written, -ENOMEM if out can't hold the header
+ */
+int evt_trace_export(uint8_t *out, size_t max);
+
+/**
+ * @brief Replay a trace, blocking until the last event was injected
+ *
+ * @param [in]  trace   Exported trace
+ * @param [in]  len     Length of trace
+ * @param [in]  speedup 1 for real time, N for N times faster, 0 back to back
+ * @param [out] stats   Replay statistics, may be NULL
+ *
+ * @return Error code, -EINVAL if trace isn't a valid trace
+ */
+int evt_trace_replay(const uint8_t *trace, size_t len, uint32_t speedup,
+                     struct evt_replay_stats *stats);
+
+#endif /* EVT_TRACE_H */
@@ -0,0 +1,89 @@
+/**
+ * @file gatt_store.c
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+
+#include "gatt_store.h"
+
+/* --------------------------------------------------------------------------
+ * Types
+ * -------------------------------------------------------------------------- */
+struct gatt_store_val {
+    uint16_t len;
+    uint16_t version;
+    uint8_t  data[GATT_STORE_VALUE_MAX];
+};
+
+/* --------------------------------------------------------------------------
+ * Global States
+ * -------------------------------------------------------------------------- */
+/* Values are small: a spinlock keeps a long read from seeing half a write */
+static struct k_spinlock     store_lock;
+static struct gatt_store_val store_vals[GATT_STORE_COUNT];
+static uint32_t              store_generation;
+
+/* --------------------------------------------------------------------------
+ * Public Functions
+ * -------------------------------------------------------------------------- */
+int gatt_store_write(gatt_store_id_t id, const void *data, uint16_t len, uint16_t offset)
+{
+    struct gatt_store_val *val = &store_vals[id];
+    int changed;
+
+    if ((uint32_t)offset + len > GATT_STORE_VALUE_MAX) {
+        return -EFBIG;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&store_lock);
+
+    if (offset > val->len) {
+        k_spin_unlock(&store_lock, key);
+        return -EINVAL;
+    }
+    changed = (offset + len != val->len) || memcmp(&val->data[offset], data, len);
+    if (changed) {
+        memcpy(&val->data[offset], data, len);
+        val->len     = offset + len;
+        val->version = (uint16_t)++store_generation;
+    }
+    k_spin_unlock(&store_lock, key);
+    return changed;
+}
+
+uint16_t gatt_store_get(gatt_store_id_t id, void *out, uint16_t max)
+{
+    k_spinlock_key_t key = k_spin_lock(&store_lock);
+    uint16_t len = MIN(store_vals[id].len, max);
+
+    memcpy(out, store_vals[id].data, len);
+    k_spin_unlock(&store_lock, key);
+    return len;
+}
+
+ssize_t gatt_store_attr_read(gatt_store_id_t id, struct bt_conn *conn,
+                             const struct bt_gatt_attr *attr, void *buf, uint16_t len,
+                             uint16_t offset)
+{
+    k_spinlock_key_t key = k_spin_lock(&store_lock);
+    ssize_t ret = bt_gatt_attr_read(conn, attr, buf, len, offset, store_vals[id].data,
+                                    store_vals[id].len);
+
+    k_spin_unlock(&store_lock, key);
+    return ret;
+}
+
+void gatt_store_gen_get(struct gatt_store_gen *out)
+{
+    k_spinlock_key_t key = k_spin_lock(&store_lock);
+
+    out->generation = sys_cpu_to_le32(store_generation);
+    for (size_t i = 0; i < GATT_STORE_COUNT; i++) {
+        out->version[i] = sys_cpu_to_le16(store_vals[i].version);
+    }
+    k_spin_unlock(&store_lock, key);
+}
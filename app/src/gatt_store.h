@@ -0,0 +1,97 @@
+/**
+ * @file gatt_store.h
+ * @brief Value store behind the secure demo service characteristics
+ *
+ * Each value is kept with its length, so reads and long-read fragments copy
+ * without scanning the value, and with the generation at which it last
+ * changed. The store generation counts changes across all values: a client
+ * that cached the service reads the generation characteristic (or reads
+ * every value in one ATT Read Multiple Variable request) to revalidate.
+ * Writes that don't change a value don't bump anything, so callers notify
+ * only on real changes.
+ */
+
+#ifndef GATT_STORE_H
+#define GATT_STORE_H
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <zephyr/toolchain.h>
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/bluetooth/gatt.h>
+
+/* --------------------------------------------------------------------------
+ * Constants
+ * -------------------------------------------------------------------------- */
+#define GATT_STORE_VALUE_MAX 64
+
+/* --------------------------------------------------------------------------
+ * Types
+ * -------------------------------------------------------------------------- */
+typedef enum {
+    GATT_STORE_SECRET = 0, /* secure read characteristic */
+    GATT_STORE_MESSAGE,    /* last value written to the secure write characteristic */
+    GATT_STORE_COUNT,
+} gatt_store_id_t;
+
+/* Value of the generation characteristic, little endian */
+struct gatt_store_gen {
+    uint32_t generation;
+    uint16_t version[GATT_STORE_COUNT]; /* low 16 bits of the generation of the last change */
+} __packed;
+
+/* --------------------------------------------------------------------------
+ * Public Functions
+ * -------------------------------------------------------------------------- */
+/**
+ * @brief Write (part of) a value
+ *
+ * Like an ATT write: the value becomes its first offset bytes followed by
+ * data.
+ *
+ * @param [in] id     Value
+ * @param [in] data   New bytes
+ * @param [in] len    Length of data
+ * @param [in] offset Where data starts in the value
+ *
+ * @return 1 if the value changed, 0 if not, -EINVAL if offset is past the
+ *         end of the value, -EFBIG if it would exceed GATT_STORE_VALUE_MAX
+ */
+int gatt_store_write(gatt_store_id_t id, const void *data, uint16_t len, uint16_t offset);
+
+/**
+ * @brief Copy a value
+ *
+ * @param [in]  id  Value
+ * @param [out] out Destination
+ * @param [in]  max Size of out
+ *
+ * @return Bytes copied
+ */
+uint16_t gatt_store_get(gatt_store_id_t id, void *out, uint16_t max);
+
+/**
+ * @brief Serve an ATT read (or read blob, or one value of a read multiple)
+ *
+ * @param [in]  id     Value
+ * @param [in]  conn   Connection, as passed to the attribute read callback
+ * @param [in]  attr   Attribute
+ * @param [out] buf    Response buffer
+ * @param [in]  len    Size of buf
+ * @param [in]  offset Read offset
+ *
+ * @return Bytes read, or a BT_GATT_ERR() code
+ */
+ssize_t gatt_store_attr_read(gatt_store_id_t id, struct bt_conn *conn,
+                             const struct bt_gatt_attr *attr, void *buf, uint16_t len,
+                             uint16_t offset);
+
+/**
+ * @brief Get the store generation and the version of every value
+ *
+ * @param [out] out Generation characteristic value
+ */
+void gatt_store_gen_get(struct gatt_store_gen *out);
+
+#endif /* GATT_STORE_H */
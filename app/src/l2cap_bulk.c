@@ -0,0 +1,405 @@
+/**
+ * @file l2cap_bulk.c
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/net_buf.h>
+
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/bluetooth/l2cap.h>
+
+#ifdef CONFIG_SHELL
+#include <zephyr/shell/shell.h>
+#include <stdlib.h>
+#endif
+
+#include "l2cap_bulk.h"
+#include "secure_svc.h"
+
+LOG_MODULE_REGISTER(l2cap_bulk, CONFIG_APP_LOG_LEVEL);
+
+/* --------------------------------------------------------------------------
+ * Constants
+ * -------------------------------------------------------------------------- */
+#define BULK_MTU     CONFIG_APP_L2CAP_BULK_MTU
+#define BULK_MPS     BT_L2CAP_RX_MTU     /* one ACL buffer per PDU */
+#define BULK_RX_SEGS CONFIG_APP_L2CAP_BULK_RX_SEGS
+#define BULK_TX_SDUS CONFIG_APP_L2CAP_BULK_TX_SDUS
+
+/* Credits go back in batches, or as soon as the reader caught up */
+#define BULK_CREDIT_BATCH MAX(BULK_RX_SEGS / 4, 1)
+
+/* --------------------------------------------------------------------------
+ * Types
+ * -------------------------------------------------------------------------- */
+/* User data of a receive buffer */
+struct bulk_seg_meta {
+    uint32_t gen; /* channel instance it arrived on */
+};
+
+/* --------------------------------------------------------------------------
+ * Global States
+ * -------------------------------------------------------------------------- */
+NET_BUF_POOL_FIXED_DEFINE(bulk_rx_pool, BULK_RX_SEGS, BULK_MPS,
+                          sizeof(struct bulk_seg_meta), NULL);
+NET_BUF_POOL_FIXED_DEFINE(bulk_tx_pool, BULK_TX_SDUS, BT_L2CAP_SDU_BUF_SIZE(BULK_MTU),
+                          0, NULL);
+
+static struct bt_l2cap_le_chan bulk_chan;
+static atomic_t                bulk_in_use;
+static K_FIFO_DEFINE(bulk_rx_fifo);
+static struct net_buf         *bulk_rx_cur; /* reader owned */
+
+/* Receive buffers are either queued, backed by a credit the peer holds,
+ * waiting to be returned as a credit, or spare (no channel to credit) */
+static struct k_spinlock       bulk_lock;
+static bool                    bulk_connected;
+static uint32_t                bulk_gen;
+static uint16_t                bulk_rx_credits;  /* held by the peer */
+static uint16_t                bulk_rx_pending;  /* freed, not yet given */
+static uint16_t                bulk_rx_spare = BULK_RX_SEGS;
+static struct l2cap_bulk_stats bulk_stats;
+
+/* --------------------------------------------------------------------------
+ * Private Functions
+ * -------------------------------------------------------------------------- */
+static uint16_t bulk_credits_take(bool flush)
+{
+    uint16_t give = 0;
+    k_spinlock_key_t key = k_spin_lock(&bulk_lock);
+
+    if (bulk_connected && bulk_rx_pending && (flush || bulk_rx_pending >= BULK_CREDIT_BATCH)) {
+        give = bulk_rx_pending;
+        bulk_rx_pending  = 0;
+        bulk_rx_credits += give;
+        bulk_stats.credits += give;
+    }
+    k_spin_unlock(&bulk_lock, key);
+    return give;
+}
+
+static void bulk_credits_give(bool flush)
+{
+    uint16_t give = bulk_credits_take(flush);
+
+    if (give) {
+        int err = bt_l2cap_chan_give_credits(&bulk_chan.chan, give);
+
+        if (err) {
+            LOG_WRN("[BULK] Giving %u credits failed (err %d)", give, err);
+        }
+    }
+}
+
+static void bulk_seg_free(struct net_buf *buf)
+{
+    net_buf_unref(buf);
+
+    k_spinlock_key_t key = k_spin_lock(&bulk_lock);
+
+    if (bulk_connected) {
+        bulk_rx_pending++;
+    } else {
+        bulk_rx_spare++;
+    }
+    k_spin_unlock(&bulk_lock, key);
+
+    bulk_credits_give(k_fifo_is_empty(&bulk_rx_fifo));
+}
+
+/* Called per PDU, so the peer's segmentation never needs an SDU-sized
+ * buffer here; the stream reader doesn't care about SDU boundaries */
+static void bulk_seg_recv(struct bt_l2cap_chan *chan, size_t sdu_len, off_t seg_offset,
+                          struct net_buf_simple *seg)
+{
+    struct net_buf *buf = net_buf_alloc(&bulk_rx_pool, K_NO_WAIT);
+    k_spinlock_key_t key = k_spin_lock(&bulk_lock);
+
+    if (bulk_rx_credits) {
+        bulk_rx_credits--;
+    }
+    if (!buf) {
+        bulk_stats.rx_dropped++;
+        k_spin_unlock(&bulk_lock, key);
+        LOG_WRN("[BULK] No buffer for a %u byte PDU", seg->len);
+        return;
+    }
+    ((struct bulk_seg_meta *)net_buf_user_data(buf))->gen = bulk_gen;
+    bulk_stats.rx_bytes += seg->len;
+    if (seg_offset + seg->len == sdu_len) {
+        bulk_stats.rx_sdus++;
+    }
+    k_spin_unlock(&bulk_lock, key);
+
+    net_buf_add_mem(buf, seg->data, seg->len);
+    k_fifo_put(&bulk_rx_fifo, buf);
+}
+
+static void bulk_sent(struct bt_l2cap_chan *chan)
+{
+    k_spinlock_key_t key = k_spin_lock(&bulk_lock);
+
+    bulk_stats.tx_sdus++;
+    k_spin_unlock(&bulk_lock, key);
+}
+
+static void bulk_chan_connected(struct bt_l2cap_chan *chan)
+{
+    k_spinlock_key_t key = k_spin_lock(&bulk_lock);
+
+    bulk_gen++;
+    bulk_connected  = true;
+    bulk_rx_pending = bulk_rx_spare;
+    bulk_rx_spare   = 0;
+    bulk_stats = (struct l2cap_bulk_stats){
+        .tx_mtu   = bulk_chan.tx.mtu,
+        .tx_mps   = bulk_chan.tx.mps,
+        .since_ms = k_uptime_get_32(),
+    };
+    k_spin_unlock(&bulk_lock, key);
+
+    LOG_INF("[BULK] Channel open (peer MTU %u, MPS %u)", bulk_chan.tx.mtu, bulk_chan.tx.mps);
+    bulk_credits_give(true);
+}
+
+static void bulk_chan_disconnected(struct bt_l2cap_chan *chan)
+{
+    k_spinlock_key_t key = k_spin_lock(&bulk_lock);
+
+    bulk_connected   = false;
+    bulk_rx_spare   += bulk_rx_credits + bulk_rx_pending;
+    bulk_rx_credits  = 0;
+    bulk_rx_pending  = 0;
+    k_spin_unlock(&bulk_lock, key);
+
+    /* A blocked reader returns -ENOTCONN */
+    k_fifo_cancel_wait(&bulk_rx_fifo);
+    LOG_INF("[BULK] Channel closed");
+}
+
+static void bulk_chan_released(struct bt_l2cap_chan *chan)
+{
+    atomic_clear(&bulk_in_use);
+}
+
+static const struct bt_l2cap_chan_ops bulk_ops = {
+    .connected    = bulk_chan_connected,
+    .disconnected = bulk_chan_disconnected,
+    .released     = bulk_chan_released,
+    .seg_recv     = bulk_seg_recv,
+    .sent         = bulk_sent,
+};
+
+static int bulk_accept(struct bt_conn *conn, struct bt_l2cap_server *server,
+                       struct bt_l2cap_chan **chan)
+{
+    if (atomic_set(&bulk_in_use, 1)) {
+        return -ENOMEM;
+    }
+    /* With seg_recv the application sets the MPS and gives every credit */
+    bulk_chan = (struct bt_l2cap_le_chan){
+        .chan.ops = &bulk_ops,
+        .rx.mtu   = BULK_MTU,
+        .rx.mps   = BULK_MPS,
+    };
+    *chan = &bulk_chan.chan;
+    return 0;
+}
+
+/* The stack rejects the connection request below security level 4 */
+static struct bt_l2cap_server bulk_server = {
+    .psm       = SECURE_BULK_PSM,
+    .sec_level = BT_SECURITY_L4,
+    .accept    = bulk_accept,
+};
+
+/* --------------------------------------------------------------------------
+ * Public Functions
+ * -------------------------------------------------------------------------- */
+bool l2cap_bulk_is_connected(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&bulk_lock);
+    bool connected = bulk_connected;
+
+    k_spin_unlock(&bulk_lock, key);
+    return connected;
+}
+
+int l2cap_bulk_write(const void *data, size_t len, k_timeout_t timeout)
+{
+    const uint8_t *src = data;
+    size_t done = 0;
+
+    while (done < len) {
+        if (!l2cap_bulk_is_connected()) {
+            return done ? (int)done : -ENOTCONN;
+        }
+
+        struct net_buf *buf = net_buf_alloc(&bulk_tx_pool, K_NO_WAIT);
+
+        if (!buf) {
+            k_spinlock_key_t key = k_spin_lock(&bulk_lock);
+
+            bulk_stats.tx_waits++;
+            k_spin_unlock(&bulk_lock, key);
+            buf = net_buf_alloc(&bulk_tx_pool, timeout);
+            if (!buf) {
+                break;
+            }
+        }
+
+        size_t n = MIN(len - done, MIN(bulk_chan.tx.mtu, BULK_MTU));
+
+        net_buf_reserve(buf, BT_L2CAP_SDU_CHAN_SEND_RESERVE);
+        net_buf_add_mem(buf, src + done, n);
+
+        int err = bt_l2cap_chan_send(&bulk_chan.chan, buf);
+
+        if (err) {
+            net_buf_unref(buf);
+            return done ? (int)done : err;
+        }
+        done += n;
+
+        k_spinlock_key_t key = k_spin_lock(&bulk_lock);
+
+        bulk_stats.tx_bytes += n;
+        k_spin_unlock(&bulk_lock, key);
+    }
+    return done ? (int)done : -EAGAIN;
+}
+
+int l2cap_bulk_read(void *data, size_t len, k_timeout_t timeout)
+{
+    uint8_t *dst = data;
+    size_t done = 0;
+
+    while (done < len) {
+        if (!bulk_rx_cur) {
+            bulk_rx_cur = k_fifo_get(&bulk_rx_fifo, done ? K_NO_WAIT : timeout);
+            if (!bulk_rx_cur) {
+                break;
+            }
+            /* Left over from an earlier channel: not part of this stream */
+            if (((struct bulk_seg_meta *)net_buf_user_data(bulk_rx_cur))->gen != bulk_gen) {
+                bulk_seg_free(bulk_rx_cur);
+                bulk_rx_cur = NULL;
+                continue;
+            }
+        }
+
+        size_t n = MIN(len - done, bulk_rx_cur->len);
+
+        memcpy(dst + done, net_buf_pull_mem(bulk_rx_cur, n), n);
+        done += n;
+        if (!bulk_rx_cur->len) {
+            bulk_seg_free(bulk_rx_cur);
+            bulk_rx_cur = NULL;
+        }
+    }
+
+    if (done) {
+        return (int)done;
+    }
+    return l2cap_bulk_is_connected() ? -EAGAIN : -ENOTCONN;
+}
+
+void l2cap_bulk_stats_get(struct l2cap_bulk_stats *out)
+{
+    k_spinlock_key_t key = k_spin_lock(&bulk_lock);
+
+    *out = bulk_stats;
+    k_spin_unlock(&bulk_lock, key);
+}
+
+static int l2cap_bulk_init(void)
+{
+    int err = bt_l2cap_server_register(&bulk_server);
+
+    if (err) {
+        LOG_ERR("[BULK] Registering PSM 0x%04x failed (err %d)", SECURE_BULK_PSM, err);
+    }
+    return err;
+}
+
+SYS_INIT(l2cap_bulk_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+#ifdef CONFIG_APP_L2CAP_BULK_SINK
+/* Stands in for an application consumer: drains the stream so credits
+ * flow back to the peer at the rate the CPU can take data */
+static void l2cap_bulk_sink_thread(void *p1, void *p2, void *p3)
+{
+    static uint8_t chunk[BULK_MPS];
+
+    while (true) {
+        l2cap_bulk_read(chunk, sizeof(chunk), K_FOREVER);
+    }
+}
+
+K_THREAD_DEFINE(l2cap_bulk_sink, CONFIG_APP_L2CAP_BULK_SINK_STACK_SIZE, l2cap_bulk_sink_thread,
+                NULL, NULL, NULL, CONFIG_APP_L2CAP_BULK_SINK_PRIORITY, 0, 0);
+#endif
+
+/* --------------------------------------------------------------------------
+ * Shell Commands
+ * -------------------------------------------------------------------------- */
+#ifdef CONFIG_SHELL
+static uint32_t bulk_rate(uint32_t bytes, uint32_t since_ms)
+{
+    uint32_t ms = MAX(k_uptime_get_32() - since_ms, 1U);
+
+    return (uint32_t)(((uint64_t)bytes * MSEC_PER_SEC) / ms);
+}
+
+static int cmd_bulk_stats(const struct shell *sh, size_t argc, char **argv)
+{
+    struct l2cap_bulk_stats st;
+
+    l2cap_bulk_stats_get(&st);
+    if (!l2cap_bulk_is_connected()) {
+        shell_print(sh, "Not connected (PSM 0x%04x), last channel:", SECURE_BULK_PSM);
+    }
+    shell_print(sh, "rx %u bytes in %u SDUs (%u B/s avg), %u credits given, %u dropped",
+                st.rx_bytes, st.rx_sdus, bulk_rate(st.rx_bytes, st.since_ms), st.credits,
+                st.rx_dropped);
+    shell_print(sh, "tx %u bytes, %u SDUs sent, %u buffer waits, peer MTU %u MPS %u",
+                st.tx_bytes, st.tx_sdus, st.tx_waits, st.tx_mtu, st.tx_mps);
+    return 0;
+}
+
+static int cmd_bulk_send(const struct shell *sh, size_t argc, char **argv)
+{
+    static uint8_t pattern[BULK_MTU]; /* one SDU per write */
+    size_t total = strtoul(argv[1], NULL, 0);
+    size_t sent = 0;
+    uint32_t start = k_uptime_get_32();
+
+    for (size_t i = 0; i < sizeof(pattern); i++) {
+        pattern[i] = (uint8_t)i;
+    }
+    while (sent < total) {
+        int ret = l2cap_bulk_write(pattern, MIN(total - sent, sizeof(pattern)), K_SECONDS(5));
+
+        if (ret < 0) {
+            shell_error(sh, "Stopped after %u bytes (err %d)", (uint32_t)sent, ret);
+            return ret;
+        }
+        sent += ret;
+    }
+    shell_print(sh, "Queued %u bytes (%u B/s)", (uint32_t)sent, bulk_rate(sent, start));
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(bulk_cmds,
+    SHELL_CMD(stats, NULL, "Transfer counters of the channel", cmd_bulk_stats),
+    SHELL_CMD_ARG(send, NULL, "Stream <bytes> of test data to the peer", cmd_bulk_send, 2, 0),
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(bulk, &bulk_cmds, "L2CAP bulk channel", NULL);
+#endif /* CONFIG_SHELL */
@@ -0,0 +1,85 @@
+/**
+ * @file l2cap_bulk.h
+ * @brief Authenticated L2CAP connection-oriented channel for bulk data
+ *
+ * A credit-based (LE CoC) channel on SECURE_BULK_PSM that only accepts
+ * peers at BT_SECURITY_L4, the level requested in connected(). Data is
+ * exposed as a byte stream: SDU boundaries are not preserved.
+ *
+ * Received PDUs are copied into a pool of CONFIG_APP_L2CAP_BULK_RX_SEGS
+ * buffers and every credit given to the peer is backed by a free buffer, so
+ * a slow reader throttles the sender instead of losing data. Writes are cut
+ * into SDUs from a pool of CONFIG_APP_L2CAP_BULK_TX_SDUS buffers, which the
+ * stack segments into PDUs as the peer grants credits.
+ */
+
+#ifndef L2CAP_BULK_H
+#define L2CAP_BULK_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <zephyr/kernel.h>
+
+/* --------------------------------------------------------------------------
+ * Types
+ * -------------------------------------------------------------------------- */
+struct l2cap_bulk_stats {
+    uint32_t rx_bytes;
+    uint32_t rx_sdus;
+    uint32_t rx_dropped;    /* PDUs without a free buffer (peer ignored credits) */
+    uint32_t credits;       /* given to the peer */
+    uint32_t tx_bytes;
+    uint32_t tx_sdus;       /* handed to the controller */
+    uint32_t tx_waits;      /* writes that waited for a free SDU buffer */
+    uint16_t tx_mtu;        /* peer's SDU and PDU sizes */
+    uint16_t tx_mps;
+    uint32_t since_ms;      /* uptime when the channel connected */
+};
+
+/* --------------------------------------------------------------------------
+ * Public Functions
+ * -------------------------------------------------------------------------- */
+/**
+ * @brief Check whether a peer has the channel open
+ *
+ * @return true if connected
+ */
+bool l2cap_bulk_is_connected(void);
+
+/**
+ * @brief Queue data for the peer
+ *
+ * Blocks while every SDU buffer is waiting for credits.
+ *
+ * @param [in] data    Data to send
+ * @param [in] len     Length of data
+ * @param [in] timeout Longest wait for each free SDU buffer
+ *
+ * @return Bytes queued, -EAGAIN on timeout before any, -ENOTCONN without a peer
+ */
+int l2cap_bulk_write(const void *data, size_t len, k_timeout_t timeout);
+
+/**
+ * @brief Read received data
+ *
+ * Returns what is available once at least one byte arrived. Consumed
+ * buffers are given back to the peer as credits. One reader at a time.
+ *
+ * @param [out] data    Destination
+ * @param [in]  len     Size of data
+ * @param [in]  timeout Longest wait for the first byte
+ *
+ * @return Bytes read, -EAGAIN on timeout, -ENOTCONN when the channel closed
+ */
+int l2cap_bulk_read(void *data, size_t len, k_timeout_t timeout);
+
+/**
+ * @brief Copy the transfer counters
+ *
+ * @param [out] out Destination
+ */
+void l2cap_bulk_stats_get(struct l2cap_bulk_stats *out);
+
+#endif /* L2CAP_BULK_H */
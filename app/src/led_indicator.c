@@ -0,0 +1,75 @@
+/**
+ * @file led_indicator.c
+ * @brief Mirrors the UI state onto the DK LEDs from its own thread
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/zbus/zbus.h>
+
+#include "LED.h"
+
+#include "events.h"
+#include "led_indicator.h"
+#include "ui.h"
+
+/* --------------------------------------------------------------------------
+ * Types
+ * -------------------------------------------------------------------------- */
+typedef struct {
+    uint8_t       on_mask;    /* LEDs held on */
+    uint8_t       blink_mask; /* LEDs blinking at blink_hz */
+    led_frequency blink_hz;
+} led_pattern_t;
+
+/* --------------------------------------------------------------------------
+ * Global States
+ * -------------------------------------------------------------------------- */
+static const led_pattern_t patterns[] = {
+    [UI_STATE_ADVERTISING] = {.blink_mask = BIT(LED0), .blink_hz = LED_1HZ},
+    [UI_STATE_CONNECTED]   = {.on_mask = BIT(LED0)},
+    [UI_STATE_PASSKEY]     = {.on_mask = BIT(LED0), .blink_mask = BIT(LED1), .blink_hz = LED_4HZ},
+    [UI_STATE_PAIRED]      = {.on_mask = BIT(LED0) | BIT(LED1)},
+    [UI_STATE_PAIR_FAILED] = {.blink_mask = BIT(LED3), .blink_hz = LED_2HZ},
+};
+
+ZBUS_MSG_SUBSCRIBER_DEFINE(led_sub);
+ZBUS_CHAN_ADD_OBS(ui_chan, led_sub, 0);
+
+/* --------------------------------------------------------------------------
+ * Private Functions
+ * -------------------------------------------------------------------------- */
+static void led_pattern_apply(const led_pattern_t *p)
+{
+    for (led_id i = LED0; i < NUM_LEDS; i++) {
+        if (p->blink_mask & BIT(i)) {
+            LED_blink(i, p->blink_hz);
+        } else {
+            LED_set(i, (p->on_mask & BIT(i)) ? LED_ON : LED_OFF);
+        }
+    }
+}
+
+static void led_indicator_thread(void *p1, void *p2, void *p3)
+{
+    const struct zbus_channel *chan;
+    struct ui_evt evt;
+
+    led_pattern_apply(&patterns[UI_STATE_ADVERTISING]);
+
+    while (0 == evt_wait(&led_sub, &chan, &evt, K_FOREVER)) {
+        if (evt.state < ARRAY_SIZE(patterns)) {
+            led_pattern_apply(&patterns[evt.state]);
+        }
+    }
+}
+
+K_THREAD_DEFINE(led_indicator, CONFIG_APP_EVT_LED_STACK_SIZE, led_indicator_thread,
+                NULL, NULL, NULL, CONFIG_APP_EVT_LED_PRIORITY, 0, SYS_FOREVER_MS);
+
+/* --------------------------------------------------------------------------
+ * Public Functions
+ * -------------------------------------------------------------------------- */
+void led_indicator_start(void)
+{
+    k_thread_start(led_indicator);
+}
@@ -0,0 +1,14 @@
+/**
+ * @file led_indicator.h
+ * @brief Mirrors the UI state onto the DK LEDs
+ */
+
+#ifndef LED_INDICATOR_H
+#define LED_INDICATOR_H
+
+/**
+ * @brief Start the indicator thread, call once LED_init() has succeeded
+ */
+void led_indicator_start(void);
+
+#endif /* LED_INDICATOR_H */
@@ -5,10 +5,9 @@
 #include <zephyr/kernel.h>
 #include <zephyr/settings/settings.h>
 #include <zephyr/sys/printk.h>
+#include <zephyr/logging/log.h>
 
-#include <zephyr/device.h>
 #include <lvgl.h>
-#include <zephyr/drivers/display.h>
 
 #include <zephyr/bluetooth/bluetooth.h>
 #include <zephyr/bluetooth/hci.h>
@@ -19,243 +18,191 @@
 #include "BTN.h"
 #include "LED.h"
 
-/* --------------------------------------------------------------------------
- * UI State Machine
- * -------------------------------------------------------------------------- */
-typedef enum {
-    UI_STATE_ADVERTISING,
-    UI_STATE_CONNECTED,
-    UI_STATE_PASSKEY,
-    UI_STATE_PAIRED,
-    UI_STATE_PAIR_FAILED,
-} ui_state_t;
-
-static K_MUTEX_DEFINE(ui_mutex);
-static ui_state_t  ui_state        = UI_STATE_ADVERTISING;
-static char        ui_passkey[16]  = {0};
-static bool        ui_needs_update = true;
- 
-/* LVGL objects — created once in ui_init(), updated in ui_render() */
-static lv_obj_t *bg_rect     = NULL;
-static lv_obj_t *label_title = NULL;
-static lv_obj_t *label_sub   = NULL;
- 
+#include "boot_trace.h"
+#include "cb_prof.h"
+#include "events.h"
+#include "gatt_store.h"
+#include "led_indicator.h"
+#include "secure_svc.h"
+#include "ui.h"
 
-static void ui_set_state(ui_state_t state, const char *passkey_str)
-{
-    k_mutex_lock(&ui_mutex, K_FOREVER);
-    ui_state = state;
-    if (passkey_str) {
-        strncpy(ui_passkey, passkey_str, sizeof(ui_passkey) - 1);
-        ui_passkey[sizeof(ui_passkey) - 1] = '\0';
-    }
-    ui_needs_update = true;
-    k_mutex_unlock(&ui_mutex);
-}
+#ifdef CONFIG_APP_CONN_PARAMS
+#include "conn_params.h"
+#endif
 
+#ifdef CONFIG_APP_SETTINGS
+#include "app_settings.h"
+#endif
 
-static void ui_render(void)
-{
-    k_mutex_lock(&ui_mutex, K_FOREVER);
- 
-    if (!ui_needs_update) {
-        k_mutex_unlock(&ui_mutex);
-        return;
-    }
- 
-    ui_state_t state = ui_state;
-    char       pk[16];
- 
-    strncpy(pk, ui_passkey, sizeof(pk));
-    ui_needs_update = false;
-    k_mutex_unlock(&ui_mutex);
- 
-    /* Colours and text for each state */
-    lv_color_t col_bg, col_title, col_sub;
-    const char *title_text;
-    const char *sub_text;
-    const lv_font_t *title_font;
- 
-    switch (state) {
- 
-    case UI_STATE_ADVERTISING:
-        col_bg     = lv_color_hex(0x003080);
-        col_title  = lv_color_hex(0xFFFFFF);
-        col_sub    = lv_color_hex(0xADD8E6);
-        title_text = "BLE Secure Demo";
-        sub_text   = "Open nRF Connect\non your phone\nand connect.";
-        title_font = &lv_font_montserrat_48;
-        break;
- 
-    case UI_STATE_CONNECTED:
-        col_bg     = lv_color_hex(0x806000);
-        col_title  = lv_color_hex(0xFFFF00);
-        col_sub    = lv_color_hex(0xFFFFFF);
-        title_text = "Connected!";
-        sub_text   = "Waiting for\npairing request...";
-        title_font = &lv_font_montserrat_28;
-        break;
- 
-    case UI_STATE_PASSKEY:
-        col_bg     = lv_color_hex(0x1A1A2E);
-        col_title  = lv_color_hex(0xFFFFFF);
-        col_sub    = lv_color_hex(0xFFD700);
-        title_text = pk;               /* "123456" */
-        sub_text   = "Match this passkey\non your phone\n(nRF Connect)";
-        title_font = &lv_font_montserrat_48; /* big digits */
-        break;
- 
-    case UI_STATE_PAIRED:
-        col_bg     = lv_color_hex(0x004000);
-        col_title  = lv_color_hex(0x00FF80);
-        col_sub    = lv_color_hex(0xFFFFFF);
-        title_text = "Paired!";
-        sub_text   = "Secure link active."; //\nGATT service\nnow accessible.";
-        title_font = &lv_font_montserrat_48;
-        break;
- 
-    case UI_STATE_PAIR_FAILED:
-    default:
-        col_bg     = lv_color_hex(0x600000);
-        col_title  = lv_color_hex(0xFF4040);
-        col_sub    = lv_color_hex(0xFFFFFF);
-        title_text = "Pairing FAILED";
-        sub_text   = "Check phone and\nretry connection.";
-        title_font = &lv_font_montserrat_28;
-        break;
-    }
- 
-    /* Apply background colour */
-    lv_obj_set_style_bg_color(bg_rect, col_bg, LV_PART_MAIN);
- 
-    /* Apply title */
-    lv_obj_set_style_text_font(label_title, title_font, LV_PART_MAIN);
-    lv_obj_set_style_text_color(label_title, col_title, LV_PART_MAIN);
-    lv_label_set_text(label_title, title_text);
- 
-    /* Apply subtitle */
-    lv_obj_set_style_text_color(label_sub, col_sub, LV_PART_MAIN);
-    lv_label_set_text(label_sub, sub_text);
- 
-    lv_refr_now(NULL);
-}
+#ifdef CONFIG_APP_SCANNER
+#include "scanner.h"
+#endif
 
-/* --------------------------------------------------------------------------
- * This function initializes LVGL screen objects
- * -------------------------------------------------------------------------- */
-static int ui_init(void)
-{
-    const struct device *display_dev =
-        DEVICE_DT_GET(DT_CHOSEN(zephyr_display));
- 
-    if (!device_is_ready(display_dev)) {
-        printk("[UI] Display device not ready\n");
-        return -ENODEV;
-    }
- 
-    display_blanking_off(display_dev);
- 
-    lv_obj_t *scr = lv_scr_act();
- 
-    /* Full-screen coloured background */
-    bg_rect = lv_obj_create(scr);
-    lv_obj_set_size(bg_rect, LV_HOR_RES, LV_VER_RES);
-    lv_obj_set_pos(bg_rect, 0, 0);
-    lv_obj_set_style_border_width(bg_rect, 0, LV_PART_MAIN);
-    lv_obj_set_style_radius(bg_rect, 0, LV_PART_MAIN);
-    lv_obj_set_style_bg_opa(bg_rect, LV_OPA_COVER, LV_PART_MAIN);
-    lv_obj_set_style_bg_color(bg_rect, lv_color_hex(0x003080), LV_PART_MAIN);
- 
-    /* Title label*/
-    label_title = lv_label_create(bg_rect);
-    lv_label_set_long_mode(label_title, LV_LABEL_LONG_WRAP);
-    lv_obj_set_width(label_title, LV_HOR_RES - 20);
-    lv_obj_align(label_title, LV_ALIGN_TOP_MID, 0, 20);
-    lv_obj_set_style_text_align(label_title, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN);
-    lv_obj_set_style_text_font(label_title, &lv_font_montserrat_28, LV_PART_MAIN);
-    lv_obj_set_style_text_color(label_title, lv_color_white(), LV_PART_MAIN);
-    lv_label_set_text(label_title, "Initialising...");
- 
-    /* Sub-title label*/
-    label_sub = lv_label_create(bg_rect);
-    lv_label_set_long_mode(label_sub, LV_LABEL_LONG_WRAP);
-    lv_obj_set_width(label_sub, LV_HOR_RES - 20);
-    lv_obj_align(label_sub, LV_ALIGN_BOTTOM_MID, 0, -20);
-    lv_obj_set_style_text_align(label_sub, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN);
-    lv_obj_set_style_text_font(label_sub, &lv_font_montserrat_16, LV_PART_MAIN);
-    lv_obj_set_style_text_color(label_sub, lv_color_white(), LV_PART_MAIN);
-    lv_label_set_text(label_sub, "");
- 
-    printk("[UI] Display initialised (%d x %d)\n", LV_HOR_RES, LV_VER_RES);
-    return 0;
-}
+#ifdef CONFIG_APP_SESSION_LOG
+#include "session_log.h"
+#endif
+
+#ifdef CONFIG_APP_STATIC_MEM
+#include "mem_budget.h"
+#endif
+
+#ifdef CONFIG_APP_DFU
+#include "dfu.h"
+#endif
+
+#ifdef CONFIG_APP_PAIR_TIMELINE
+#include "pair_timeline.h"
+#define PAIR_MARK(conn, mark) pair_timeline_mark(conn, mark)
+#else
+#define PAIR_MARK(conn, mark)
+#endif
+
+LOG_MODULE_REGISTER(app, CONFIG_APP_LOG_LEVEL);
 
 /* --------------------------------------------------------------------------
  * GATT Callbacks
  * -------------------------------------------------------------------------- */
 static const char secure_data[] = "SECRET: Pairing Successful! Secure BLE Demo.";
-static uint8_t    write_buf[64];
-static uint16_t   write_buf_len;
  
+/* Serves the secret and the last written message, attr->user_data holds
+ * the gatt_store_id_t */
 static ssize_t read_secure_data(struct bt_conn *conn,
                                 const struct bt_gatt_attr *attr,
                                 void *buf, uint16_t len, uint16_t offset)
 {
-    const char *value = attr->user_data;
- 
-    printk("[GATT] Secure read from authenticated peer.\n");
-    return bt_gatt_attr_read(conn, attr, buf, len, offset, value, strlen(value));
+    CB_PROF_START();
+ 
+    PAIR_MARK(conn, PT_MARK_FIRST_GATT);
+    LOG_DBG("[GATT] Secure read from authenticated peer.");
+#ifdef CONFIG_APP_CONN_PARAMS
+    conn_params_activity(conn);
+#endif
+    ssize_t ret = gatt_store_attr_read(POINTER_TO_UINT(attr->user_data), conn, attr, buf,
+                                       len, offset);
+
+    CB_PROF_STOP(CB_PROF_GATT_READ);
+    return ret;
+}
+
+static ssize_t read_secure_gen(struct bt_conn *conn,
+                               const struct bt_gatt_attr *attr,
+                               void *buf, uint16_t len, uint16_t offset)
+{
+    struct gatt_store_gen gen;
+
+    gatt_store_gen_get(&gen);
+    return bt_gatt_attr_read(conn, attr, buf, len, offset, &gen, sizeof(gen));
 }
  
+/* Long write being assembled: end of the prepared fragments, and whether
+ * an executed fragment changed the value. Only used from the BT RX thread. */
+static uint16_t long_write_end;
+static bool     long_write_changed;
+
 static ssize_t write_secure_data(struct bt_conn *conn,
                                  const struct bt_gatt_attr *attr,
                                  const void *buf, uint16_t len,
                                  uint16_t offset, uint8_t flags)
 {
-    if (offset + len > sizeof(write_buf) - 1) {
-        return BT_GATT_ERR(BT_ATT_ERR_INVALID_OFFSET);
+    ssize_t ret = len;
+
+    /* Every exit goes through out so the profiler sees rejected writes too */
+    CB_PROF_START();
+
+    if (offset + len > SECURE_WRITE_MAX_LEN) {
+        ret = BT_GATT_ERR(BT_ATT_ERR_INVALID_OFFSET);
+        goto out;
+    }
+
+    if (flags & BT_GATT_WRITE_FLAG_PREPARE) {
+        /* Checked only, the stack queues the data until Execute Write. A
+         * fragment at offset 0 starts a new value, also after a cancel. */
+        if (offset == 0) {
+            long_write_end = 0;
+        }
+        long_write_end = MAX(long_write_end, offset + len);
+        goto out;
     }
  
-    memcpy(write_buf + offset, buf, len);
-    write_buf_len = offset + len;
-    write_buf[write_buf_len] = '\0';
-    printk("[GATT] Secure write (%u bytes): %s\n", write_buf_len, write_buf);
-    return len;
+    PAIR_MARK(conn, PT_MARK_FIRST_GATT);
+#ifdef CONFIG_APP_CONN_PARAMS
+    conn_params_activity(conn);
+#endif
+
+#ifdef CONFIG_APP_SESSION_LOG
+    session_log_gatt_write(bt_gatt_attr_get_handle(attr), offset, len);
+#endif
+
+    int changed = gatt_store_write(GATT_STORE_MESSAGE, buf, len, offset);
+
+    if (changed < 0) {
+        ret = BT_GATT_ERR(BT_ATT_ERR_INVALID_OFFSET);
+        goto out;
+    }
+
+    if (flags & BT_GATT_WRITE_FLAG_EXECUTE) {
+        /* Fragments are executed in order: hold the notification until
+         * the last one has completed the value */
+        long_write_changed |= (changed > 0);
+        if (offset + len < long_write_end) {
+            goto out;
+        }
+        changed = long_write_changed;
+        long_write_changed = false;
+        long_write_end = 0;
+    }
+
+    char text[SECURE_WRITE_MAX_LEN + 1];
+    uint16_t text_len = gatt_store_get(GATT_STORE_MESSAGE, text, SECURE_WRITE_MAX_LEN);
+
+    text[text_len] = '\0';
+    if (changed) {
+        /* Subscribers only hear about values that differ */
+        bt_gatt_notify(NULL, attr, text, text_len);
+        LOG_INF("[GATT] Secure write (%u bytes): %s", text_len, text);
+    } else {
+        LOG_DBG("[GATT] Secure write (%u bytes), unchanged", text_len);
+    }
+
+out:
+    CB_PROF_STOP(CB_PROF_GATT_WRITE);
+    return ret;
 }
 
 /* --------------------------------------------------------------------------
- * Custom UUIDs
+ * Secure Service
  * -------------------------------------------------------------------------- */
-#define BT_UUID_SECURE_DEMO_SERVICE_VAL \
-    BT_UUID_128_ENCODE(0x12345678, 0x1234, 0x5678, 0x1234, 0x56789abcdef0)
-#define BT_UUID_SECURE_READ_CHAR_VAL \
-    BT_UUID_128_ENCODE(0x12345678, 0x1234, 0x5678, 0x1234, 0x56789abcdef1)
-#define BT_UUID_SECURE_WRITE_CHAR_VAL \
-    BT_UUID_128_ENCODE(0x12345678, 0x1234, 0x5678, 0x1234, 0x56789abcdef2)
- 
-#define BT_UUID_SECURE_DEMO_SERVICE  BT_UUID_DECLARE_128(BT_UUID_SECURE_DEMO_SERVICE_VAL)
-#define BT_UUID_SECURE_READ_CHAR     BT_UUID_DECLARE_128(BT_UUID_SECURE_READ_CHAR_VAL)
-#define BT_UUID_SECURE_WRITE_CHAR    BT_UUID_DECLARE_128(BT_UUID_SECURE_WRITE_CHAR_VAL)
- 
+/* Every value is readable, so a client gets the whole service with one ATT
+ * Read Multiple Variable request */
 BT_GATT_SERVICE_DEFINE(secure_demo_svc,
     BT_GATT_PRIMARY_SERVICE(BT_UUID_SECURE_DEMO_SERVICE),
     BT_GATT_CHARACTERISTIC(BT_UUID_SECURE_READ_CHAR,
                            BT_GATT_CHRC_READ,
                            BT_GATT_PERM_READ_AUTHEN,
                            read_secure_data, NULL,
-                           (void *)secure_data),
+                           UINT_TO_POINTER(GATT_STORE_SECRET)),
     BT_GATT_CHARACTERISTIC(BT_UUID_SECURE_WRITE_CHAR,
-                           BT_GATT_CHRC_WRITE,
-                           BT_GATT_PERM_WRITE_AUTHEN,
-                           NULL, write_secure_data, NULL),
+                           BT_GATT_CHRC_READ | BT_GATT_CHRC_WRITE | BT_GATT_CHRC_NOTIFY,
+                           BT_GATT_PERM_READ_AUTHEN | BT_GATT_PERM_WRITE_AUTHEN |
+                           BT_GATT_PERM_PREPARE_WRITE,
+                           read_secure_data, write_secure_data,
+                           UINT_TO_POINTER(GATT_STORE_MESSAGE)),
+    BT_GATT_CCC(NULL, BT_GATT_PERM_READ | BT_GATT_PERM_WRITE_AUTHEN),
+    BT_GATT_CHARACTERISTIC(BT_UUID_SECURE_GEN_CHAR,
+                           BT_GATT_CHRC_READ,
+                           BT_GATT_PERM_READ_AUTHEN,
+                           read_secure_gen, NULL, NULL),
 );
  
 /* --------------------------------------------------------------------------
  * Advertising data
  * -------------------------------------------------------------------------- */
+/* Flags (3) + service UUID (18) leave 10 bytes for the shortened name. The
+ * UUID lets scanners (src/scan_table.c, bench/bsim_central) filter on it. */
 static const struct bt_data ad[] = {
     BT_DATA_BYTES(BT_DATA_FLAGS, (BT_LE_AD_GENERAL | BT_LE_AD_NO_BREDR)),
-    BT_DATA(BT_DATA_NAME_SHORTENED, "Secure Demo", 10),
+    BT_DATA_BYTES(BT_DATA_UUID128_ALL, BT_UUID_SECURE_DEMO_SERVICE_VAL),
+    BT_DATA(BT_DATA_NAME_SHORTENED, "Secure Demo", 8),
 };
  
 static const struct bt_data sd[] = {
@@ -270,67 +217,81 @@ static struct bt_conn *current_conn;
 /* This function displays passkey and requires user to input the passkey displayed */
 static void auth_passkey_display(struct bt_conn *conn, unsigned int passkey)
 {
+    CB_PROF_START();
     char addr[BT_ADDR_LE_STR_LEN];
-    char pk_str[16];
+    struct sec_evt evt = {.type = SEC_EVT_PASSKEY, .passkey = passkey};
  
     bt_addr_le_to_str(bt_conn_get_dst(conn), addr, sizeof(addr));
-    snprintk(pk_str, sizeof(pk_str), "%06u", passkey);
+    PAIR_MARK(conn, PT_MARK_PASSKEY);
  
-    printk("\n============================================\n");
-    printk("  PASSKEY REQUIRED\n");
-    printk("  Peer:    %s\n", addr);
-    printk("  Passkey: %s\n", pk_str);
-    printk("  Write code on nRF Connect mobile app\n");
-    printk("============================================\n\n");
+    /* One message so the passkey can't be split by a dropped fragment */
+    LOG_WRN("[AUTH] PASSKEY %06u for %s, enter it on nRF Connect", passkey, addr);
  
-    ui_set_state(UI_STATE_PASSKEY, pk_str);
+    evt_publish(&sec_chan, &evt);
+    CB_PROF_STOP(CB_PROF_PASSKEY_DISPLAY);
 }
 
 /* This function confirms whether the passkey matches the user (Uses LSE and NC and is L4)*/
 static void auth_passkey_confirm(struct bt_conn *conn, unsigned int passkey)
 {
+    CB_PROF_START();
     char addr[BT_ADDR_LE_STR_LEN];
-    char pk_str[16];
+    struct sec_evt evt = {.type = SEC_EVT_PASSKEY, .passkey = passkey};
  
     bt_addr_le_to_str(bt_conn_get_dst(conn), addr, sizeof(addr));
-    snprintk(pk_str, sizeof(pk_str), "%06u", passkey);
+    PAIR_MARK(conn, PT_MARK_PASSKEY);
  
-    printk("\n============================================\n");
-    printk("  NUMERIC COMPARISON\n");
-    printk("  Passkey: %s — confirm on your phone!\n", pk_str);
-    printk("  (Auto-confirming on device side)\n");
-    printk("============================================\n\n");
+    LOG_WRN("[AUTH] NUMERIC COMPARISON %06u, confirm on your phone "
+            "(auto-confirming on device side)", passkey);
  
-    ui_set_state(UI_STATE_PASSKEY, pk_str);
+    evt_publish(&sec_chan, &evt);
     bt_conn_auth_passkey_confirm(conn);
+    CB_PROF_STOP(CB_PROF_PASSKEY_CONFIRM);
 }
 
-/* This function addresses the case where pairing fails (wrong passkey / unconfirmed NC) */
+/* This function addresses the case where pairing fails (wrong passkey / unconfirmed NC).
+ * SMP follows up with pairing_failed(), which publishes the failure once. */
 static void auth_cancel(struct bt_conn *conn)
 {
+    CB_PROF_START();
     char addr[BT_ADDR_LE_STR_LEN];
     bt_addr_le_to_str(bt_conn_get_dst(conn), addr, sizeof(addr));
-    printk("[AUTH] Pairing cancelled by %s\n", addr);
-    ui_set_state(UI_STATE_PAIR_FAILED, NULL);
+    PAIR_MARK(conn, PT_MARK_PAIRING_DONE);
+    LOG_WRN("[AUTH] Pairing cancelled by %s", addr);
+    CB_PROF_STOP(CB_PROF_AUTH_CANCEL);
 }
 
 /* This function addresses the case where the pairing is successful */ 
 static void pairing_complete(struct bt_conn *conn, bool bonded)
 {
+    CB_PROF_START();
     char addr[BT_ADDR_LE_STR_LEN];
     bt_addr_le_to_str(bt_conn_get_dst(conn), addr, sizeof(addr));
-    printk("\n[AUTH] Pairing complete — %s (bonded: %s)\n\n",
-           addr, bonded ? "YES" : "NO");
-    ui_set_state(UI_STATE_PAIRED, NULL);
+    LOG_INF("[AUTH] Pairing complete — %s (bonded: %s)",
+            addr, bonded ? "YES" : "NO");
+#ifdef CONFIG_APP_PAIR_TIMELINE
+    pair_timeline_result(conn, 0);
+#endif
+    struct sec_evt evt = {.type = SEC_EVT_PAIRED, .bonded = bonded};
+
+    evt_publish(&sec_chan, &evt);
+    CB_PROF_STOP(CB_PROF_PAIRING_COMPLETE);
 }
 
 /* This function addresses the case where the pairing fails */
 static void pairing_failed(struct bt_conn *conn, enum bt_security_err reason)
 {
+    CB_PROF_START();
     char addr[BT_ADDR_LE_STR_LEN];
     bt_addr_le_to_str(bt_conn_get_dst(conn), addr, sizeof(addr));
-    printk("[AUTH] Pairing FAILED — %s (reason %d)\n", addr, reason);
-    ui_set_state(UI_STATE_PAIR_FAILED, NULL);
+    LOG_ERR("[AUTH] Pairing FAILED — %s (reason %d)", addr, reason);
+#ifdef CONFIG_APP_PAIR_TIMELINE
+    pair_timeline_result(conn, reason);
+#endif
+    struct sec_evt evt = {.type = SEC_EVT_FAILED, .err = reason};
+
+    evt_publish(&sec_chan, &evt);
+    CB_PROF_STOP(CB_PROF_PAIRING_FAILED);
 }
  
 static struct bt_conn_auth_cb auth_cb = {
@@ -349,97 +310,180 @@ static struct bt_conn_auth_info_cb auth_info_cb = {
  * -------------------------------------------------------------------------- */
 static void connected(struct bt_conn *conn, uint8_t err)
 {
+    CB_PROF_START();
     char addr[BT_ADDR_LE_STR_LEN];
  
     if (err) {
-        printk("[CONN] Connection failed (err %u)\n", err);
-        return;
+        LOG_ERR("[CONN] Connection failed (err %u)", err);
+        goto out;
     }
+    PAIR_MARK(conn, PT_MARK_CONNECTED);
  
     bt_addr_le_to_str(bt_conn_get_dst(conn), addr, sizeof(addr));
-    printk("\n[CONN] Connected: %s\n", addr);
+    LOG_INF("[CONN] Connected: %s", addr);
  
     current_conn = bt_conn_ref(conn);
-    ui_set_state(UI_STATE_CONNECTED, NULL);
+
+    struct conn_evt evt = {.type = CONN_EVT_CONNECTED};
+
+    bt_addr_le_copy(&evt.peer, bt_conn_get_dst(conn));
+    evt_publish(&conn_chan, &evt);
  
     #ifdef CONFIG_BT_SMP
+    PAIR_MARK(conn, PT_MARK_SEC_REQUEST);
     int sec_err = bt_conn_set_security(conn, BT_SECURITY_L4);
     if (sec_err) {
-        printk("[CONN] Failed to set security (err %d)\n", sec_err);
+        LOG_ERR("[CONN] Failed to set security (err %d)", sec_err);
     }
     #endif // CONFIG_BT_SMP
-    
+
+out:
+    CB_PROF_STOP(CB_PROF_CONNECTED);
 }
  
 static void disconnected(struct bt_conn *conn, uint8_t reason)
 {
+    CB_PROF_START();
     char addr[BT_ADDR_LE_STR_LEN];
  
     bt_addr_le_to_str(bt_conn_get_dst(conn), addr, sizeof(addr));
-    printk("\n[CONN] Disconnected: %s (reason 0x%02x)\n\n", addr, reason);
+    LOG_INF("[CONN] Disconnected: %s (reason 0x%02x)", addr, reason);
  
+#ifdef CONFIG_APP_PAIR_TIMELINE
+    pair_timeline_close(conn);
+#endif
+
     if (current_conn) {
         bt_conn_unref(current_conn);
         current_conn = NULL;
     }
  
-    ui_set_state(UI_STATE_ADVERTISING, NULL);
+    struct conn_evt evt = {.type = CONN_EVT_DISCONNECTED, .reason = reason};
+
+    bt_addr_le_copy(&evt.peer, bt_conn_get_dst(conn));
+    evt_publish(&conn_chan, &evt);
  
     bt_unpair(BT_ID_DEFAULT, bt_conn_get_dst(conn)); // unpairs after disconnected (USED FOR DEMO ONLY)
     int err = bt_le_adv_start(BT_LE_ADV_CONN, ad, ARRAY_SIZE(ad),
                                sd, ARRAY_SIZE(sd));
 
     if (err) {
-        printk("[ADV] Failed to restart advertising (err %d)\n", err);
+        LOG_ERR("[ADV] Failed to restart advertising (err %d)", err);
     }
+    CB_PROF_STOP(CB_PROF_DISCONNECTED);
+
+#ifdef CONFIG_APP_CB_PROFILE
+    cb_prof_log();
+#endif
 }
  
 static void security_changed(struct bt_conn *conn, bt_security_t level,
                               enum bt_security_err err)
 {
+    CB_PROF_START();
     char addr[BT_ADDR_LE_STR_LEN];
     bt_addr_le_to_str(bt_conn_get_dst(conn), addr, sizeof(addr));
+    PAIR_MARK(conn, PT_MARK_SECURITY);
+
+    struct sec_evt evt = {.type = SEC_EVT_LEVEL_CHANGED, .level = level, .err = err};
+
+    evt_publish(&sec_chan, &evt);
  
     if (!err) {
-        printk("[SEC] Security L%d active for %s\n", level, addr);
+        LOG_INF("[SEC] Security L%d active for %s", level, addr);
     } else {
-        printk("[SEC] Security change FAILED for %s (err %d)\n", addr, err);
+        LOG_ERR("[SEC] Security change FAILED for %s (err %d)", addr, err);
     }
+    CB_PROF_STOP(CB_PROF_SECURITY_CHANGED);
 }
  
 BT_CONN_CB_DEFINE(conn_callbacks) = {
     .connected        = connected,
     .disconnected     = disconnected,
-    // .security_changed = security_changed,
+    .security_changed = security_changed,
 };
 
+/* --------------------------------------------------------------------------
+ * Buttons
+ * -------------------------------------------------------------------------- */
+static void btn_pressed(btn_id btn)
+{
+    struct btn_evt evt = {.btn = btn};
+
+    evt_publish(&btn_chan, &evt);
+}
+
 #define SLEEP_MS 1
 
+/* --------------------------------------------------------------------------
+ * Boot
+ * -------------------------------------------------------------------------- */
+/* Set once bt_ready() has run to its end, whether BT came up or not */
+static atomic_t bt_boot_done;
+
+/* Runs once the BT stack is up, while main() is still bringing up the
+ * display: restores bonds and starts advertising right away. Other
+ * settings subtrees load afterwards in the background. */
+static void bt_ready(int err)
+{
+  if (err) {
+    LOG_ERR("[BT] Bluetooth init failed (err %d)", err);
+    goto done;
+  }
+  BOOT_MARK(BOOT_STAGE_BT_READY);
+
+#ifdef CONFIG_APP_SETTINGS
+  app_settings_load_bt();
+  /* Low-priority queue: runs whenever BT and the UI leave the CPU idle */
+  app_settings_load_deferred();
+#else
+  settings_load();
+#endif
+  BOOT_MARK(BOOT_STAGE_SETTINGS_LOADED);
+
+  err = bt_le_adv_start(BT_LE_ADV_CONN, ad, ARRAY_SIZE(ad),
+                          sd, ARRAY_SIZE(sd));
+  if (err) {
+    LOG_ERR("[ADV] Advertising start failed (err %d)", err);
+    goto done;
+  }
+  BOOT_MARK(BOOT_STAGE_ADV_STARTED);
+
+  LOG_INF("[ADV] Advertising as \"BLE SecureDemo\".");
+  LOG_INF("[ADV] Passkey will appear on LCD and serial console.");
+#ifdef CONFIG_APP_SCANNER
+  scanner_start();
+#endif
+#ifdef CONFIG_APP_DFU
+  /* Advertising again after an update: keep the new image */
+  dfu_init();
+#endif
+#ifdef CONFIG_APP_BOOT_TRACE
+  boot_trace_log();
+#endif
+
+done:
+  atomic_set(&bt_boot_done, true);
+}
+
 int main(void) {
+  BOOT_MARK(BOOT_STAGE_MAIN);
   if (0 > BTN_init()) {
     return 0;
   }
+  BTN_set_callback(btn_pressed);
   if (0 > LED_init()) {
     return 0;
   }
+  led_indicator_start();
+  BOOT_MARK(BOOT_STAGE_DRIVERS);
 
   int err;
-  /* Initialise display — non-fatal if absent */
-  err = ui_init();
-  if (err) {
-    printk("[UI] No display found, continuing without LCD.\n");
-  } else {
-    ui_render(); /* show initial "advertising" screen */
-  }
- 
-  /* Initialise Bluetooth */
-  err = bt_enable(NULL);
-  if (err) {
-    printk("[BT] Bluetooth init failed (err %d)\n", err);
-    return err;
-  }
-  settings_load();
+  /* Before the service can be read */
+  gatt_store_write(GATT_STORE_SECRET, secure_data, sizeof(secure_data) - 1, 0);
 
+  /* Auth callbacks must be in place before bonds are loaded and the first
+   * peer can connect */
   #ifdef CONFIG_BT_SMP
   err = bt_conn_auth_cb_register(&auth_cb);
   if (err) { return err; }
@@ -447,21 +491,43 @@ int main(void) {
   err = bt_conn_auth_info_cb_register(&auth_info_cb);
   if (err) { return err; }
   #endif
- 
-  err = bt_le_adv_start(BT_LE_ADV_CONN, ad, ARRAY_SIZE(ad),
-                          sd, ARRAY_SIZE(sd));
+
+  /* Bluetooth comes up in the background, see bt_ready() */
+  err = bt_enable(bt_ready);
   if (err) {
-    printk("[ADV] Advertising start failed (err %d)\n", err);
+    LOG_ERR("[BT] Bluetooth init failed (err %d)", err);
     return err;
   }
+  BOOT_MARK(BOOT_STAGE_BT_REQUESTED);
 
-  printk("[ADV] Advertising as \"BLE SecureDemo\".\n");
-  printk("[ADV] Passkey will appear on LCD and serial console.\n\n");
-
+  /* Initialise display — non-fatal if absent */
+  err = ui_init();
+  if (err) {
+    LOG_WRN("[UI] No display found, continuing without LCD.");
+  } else {
+    BOOT_MARK(BOOT_STAGE_UI_INIT);
+    ui_render(); /* show initial "advertising" screen */
+    BOOT_MARK(BOOT_STAGE_FIRST_FRAME);
+  }
   while (1) {
+    if (ui_is_blanked()) {
+      /* Nothing to draw: sleep until an event (e.g. the wake-up) arrives */
+      ui_process_events(K_FOREVER);
+      continue;
+    }
     uint32_t sleep_ms = lv_task_handler();
     ui_render();
-    k_msleep(MIN(sleep_ms,10));
+#ifdef CONFIG_APP_STATIC_MEM
+    /* bt_ready() runs concurrently with the first frames and allocates
+     * (settings, advertising, scanner, DFU). Once it is done every boot
+     * stage is, and the heaps must not grow from here on. */
+    if (atomic_get(&bt_boot_done)) {
+      mem_budget_seal();
+    }
+    mem_budget_check();
+#endif
+    /* Sleeps until the next LVGL tick unless a bus event arrives first */
+    ui_process_events(K_MSEC(MIN(sleep_ms,10)));
   }
   return 0;
 }
@@ -0,0 +1,128 @@
+/**
+ * @file mem_budget.c
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/heap_listener.h>
+#include <zephyr/sys/sys_heap.h>
+
+#ifdef CONFIG_LV_Z_MEM_POOL_SYS_HEAP
+#include <lvgl_mem.h>
+#endif
+
+#ifdef CONFIG_SHELL
+#include <zephyr/shell/shell.h>
+#endif
+
+#include "mem_budget.h"
+
+LOG_MODULE_REGISTER(mem_budget, CONFIG_APP_LOG_LEVEL);
+
+/* --------------------------------------------------------------------------
+ * Global States
+ * -------------------------------------------------------------------------- */
+#if K_HEAP_MEM_POOL_SIZE > 0
+/* kernel/mempool.c defines it under the same condition, there's no accessor */
+extern struct k_heap _system_heap;
+#endif
+
+static struct mem_budget_stats budget;
+static atomic_t                budget_sys_late;
+
+/* --------------------------------------------------------------------------
+ * Private Functions
+ * -------------------------------------------------------------------------- */
+#if K_HEAP_MEM_POOL_SIZE > 0
+/* Any thread or ISR, from inside the allocator */
+static void budget_sys_alloc(uintptr_t heap_id, void *mem, size_t bytes)
+{
+    if (atomic_inc(&budget_sys_late) == 0) {
+        LOG_ERR("Heap allocation of %u bytes after boot", (uint32_t)bytes);
+    }
+    __ASSERT(false, "heap allocation of %u bytes after boot", (uint32_t)bytes);
+}
+
+HEAP_LISTENER_ALLOC_DEFINE(budget_sys_listener, HEAP_ID_FROM_POINTER(&_system_heap.heap),
+                           budget_sys_alloc);
+#endif
+
+/* --------------------------------------------------------------------------
+ * Public Functions
+ * -------------------------------------------------------------------------- */
+void mem_budget_seal(void)
+{
+    struct sys_memory_stats st;
+
+    if (budget.sealed) {
+        return;
+    }
+
+#if K_HEAP_MEM_POOL_SIZE > 0
+    budget.sys_heap_size = K_HEAP_MEM_POOL_SIZE;
+    if (0 == sys_heap_runtime_stats_get(&_system_heap.heap, &st)) {
+        budget.sys_heap_boot = st.allocated_bytes;
+    }
+    heap_listener_register(&budget_sys_listener);
+#endif
+#ifdef CONFIG_LV_Z_MEM_POOL_SYS_HEAP
+    lvgl_heap_stats(&st);
+    budget.lvgl_pool_size = CONFIG_LV_Z_MEM_POOL_SIZE;
+    budget.lvgl_boot      = st.allocated_bytes;
+    budget.lvgl_peak      = st.max_allocated_bytes;
+#endif
+    budget.sealed = true;
+
+    LOG_INF("Sealed: system heap %u/%u, LVGL pool %u/%u (peak %u)", budget.sys_heap_boot,
+            budget.sys_heap_size, budget.lvgl_boot, budget.lvgl_pool_size, budget.lvgl_peak);
+}
+
+void mem_budget_check(void)
+{
+#ifdef CONFIG_LV_Z_MEM_POOL_SYS_HEAP
+    struct sys_memory_stats st;
+
+    if (!budget.sealed) {
+        return;
+    }
+    lvgl_heap_stats(&st);
+    budget.lvgl_peak = st.max_allocated_bytes;
+    if (st.allocated_bytes > budget.lvgl_boot) {
+        if (budget.lvgl_growths++ == 0) {
+            LOG_ERR("LVGL pool grew after boot: %u > %u bytes", (uint32_t)st.allocated_bytes,
+                    budget.lvgl_boot);
+        }
+        __ASSERT(false, "LVGL pool grew after boot");
+    }
+#endif
+}
+
+void mem_budget_stats_get(struct mem_budget_stats *out)
+{
+    *out = budget;
+    out->sys_heap_late = atomic_get(&budget_sys_late);
+}
+
+/* --------------------------------------------------------------------------
+ * Shell Commands
+ * -------------------------------------------------------------------------- */
+#ifdef CONFIG_SHELL
+static int cmd_mem_budget(const struct shell *sh, size_t argc, char **argv)
+{
+    struct mem_budget_stats st;
+
+    mem_budget_stats_get(&st);
+    if (!st.sealed) {
+        shell_print(sh, "Still booting");
+        return 0;
+    }
+    shell_print(sh, "System heap %u/%u bytes at boot, %u allocations since",
+                st.sys_heap_boot, st.sys_heap_size, st.sys_heap_late);
+    shell_print(sh, "LVGL pool %u/%u bytes at boot, peak %u, %u growths since",
+                st.lvgl_boot, st.lvgl_pool_size, st.lvgl_peak, st.lvgl_growths);
+    return 0;
+}
+
+SHELL_CMD_REGISTER(budget, NULL, "Heap use against the static memory budget", cmd_mem_budget);
+#endif /* CONFIG_SHELL */
@@ -0,0 +1,58 @@
+/**
+ * @file mem_budget.h
+ * @brief Static memory budget: no heap growth once the device has booted
+ *
+ * Every UI object is created in ui_init() from the fixed-size LVGL pool, and
+ * label text and styles live in static storage, so after the first frame the
+ * pool only serves LVGL's per-frame draw tasks, which are freed before
+ * lv_task_handler() returns. mem_budget_seal() records the pool use once
+ * Bluetooth start-up has finished too. From then on any system heap allocation, or LVGL pool use between
+ * frames above the sealed level, is counted, logged and asserted on.
+ *
+ * The per-module RAM report of the build is written by app/ram_budget.py.
+ */
+
+#ifndef MEM_BUDGET_H
+#define MEM_BUDGET_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* --------------------------------------------------------------------------
+ * Types
+ * -------------------------------------------------------------------------- */
+struct mem_budget_stats {
+    bool     sealed;
+    uint32_t sys_heap_size;
+    uint32_t sys_heap_boot;     /* allocated when sealed */
+    uint32_t sys_heap_late;     /* allocations after sealing */
+    uint32_t lvgl_pool_size;
+    uint32_t lvgl_boot;         /* allocated when sealed */
+    uint32_t lvgl_peak;         /* incl. draw tasks */
+    uint32_t lvgl_growths;      /* checks that found more than lvgl_boot */
+};
+
+/* --------------------------------------------------------------------------
+ * Public Functions
+ * -------------------------------------------------------------------------- */
+/**
+ * @brief End of boot: record heap use, later allocations are violations
+ *
+ * Call from the thread running LVGL once the first frame was drawn and
+ * bt_ready() has finished. Calls after the first do nothing.
+ */
+void mem_budget_seal(void);
+
+/**
+ * @brief Check the LVGL pool between frames, from the thread running LVGL
+ */
+void mem_budget_check(void);
+
+/**
+ * @brief Get the budget statistics
+ *
+ * @param [out] out Statistics
+ */
+void mem_budget_stats_get(struct mem_budget_stats *out);
+
+#endif /* MEM_BUDGET_H */
@@ -0,0 +1,274 @@
+/**
+ * @file pair_timeline.c
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/sys/byteorder.h>
+
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/bluetooth/uuid.h>
+#include <zephyr/bluetooth/gatt.h>
+
+#ifdef CONFIG_SHELL
+#include <zephyr/shell/shell.h>
+#endif
+
+#include "pair_timeline.h"
+
+/* --------------------------------------------------------------------------
+ * Constants
+ * -------------------------------------------------------------------------- */
+#define PT_SESSIONS CONFIG_APP_PAIR_TIMELINE_SESSIONS
+
+/* --------------------------------------------------------------------------
+ * Types
+ * -------------------------------------------------------------------------- */
+struct pt_session {
+    struct bt_conn *conn;              /* non-NULL while the session is open */
+    uint32_t        cycles[PT_MARK_COUNT];
+    uint8_t         marks;             /* bitmask of pt_mark_t recorded */
+    int8_t          reason;            /* -1 pending, 0 paired, > 0 bt_security_err */
+    bool            used;
+};
+
+struct pt_phase_def {
+    const char *name;
+    pt_mark_t   from;
+    pt_mark_t   to;
+};
+
+/* --------------------------------------------------------------------------
+ * Global States
+ * -------------------------------------------------------------------------- */
+/* Every phase ends on a mark that always lands after its start. The order of
+ * security_changed and pairing_complete depends on the key distribution, so
+ * neither is measured from the other. */
+static const struct pt_phase_def phase_defs[PT_PHASE_COUNT] = {
+    [PT_PHASE_SEC_REQUEST] = {"sec_req", PT_MARK_CONNECTED,    PT_MARK_SEC_REQUEST},
+    [PT_PHASE_PASSKEY]     = {"passkey", PT_MARK_SEC_REQUEST,  PT_MARK_PASSKEY},
+    [PT_PHASE_USER]        = {"user",    PT_MARK_PASSKEY,      PT_MARK_SECURITY},
+    [PT_PHASE_PAIRING]     = {"pairing", PT_MARK_PASSKEY,      PT_MARK_PAIRING_DONE},
+    [PT_PHASE_GATT]        = {"gatt",    PT_MARK_PAIRING_DONE, PT_MARK_FIRST_GATT},
+    [PT_PHASE_TOTAL]       = {"total",   PT_MARK_CONNECTED,    PT_MARK_FIRST_GATT},
+};
+
+static struct k_spinlock pt_lock;
+static struct pt_session sessions[PT_SESSIONS];
+static uint8_t           session_next;
+
+/* --------------------------------------------------------------------------
+ * Private Functions
+ * -------------------------------------------------------------------------- */
+/* Must be called with pt_lock held */
+static struct pt_session *session_find(struct bt_conn *conn)
+{
+    for (size_t i = 0; i < PT_SESSIONS; i++) {
+        if (sessions[i].conn == conn) {
+            return &sessions[i];
+        }
+    }
+    return NULL;
+}
+
+static bool phase_us(const struct pt_session *s, const struct pt_phase_def *def,
+                     uint32_t *us)
+{
+    if (!(s->marks & BIT(def->from)) || !(s->marks & BIT(def->to))) {
+        return false;
+    }
+
+    /* Unsigned difference stays right across a cycle counter wrap */
+    *us = k_cyc_to_us_floor32(s->cycles[def->to] - s->cycles[def->from]);
+    return true;
+}
+
+/* --------------------------------------------------------------------------
+ * Public Functions
+ * -------------------------------------------------------------------------- */
+void pair_timeline_mark(struct bt_conn *conn, pt_mark_t mark)
+{
+    uint32_t now = k_cycle_get_32();
+    k_spinlock_key_t key = k_spin_lock(&pt_lock);
+    struct pt_session *s;
+
+    if (mark == PT_MARK_CONNECTED) {
+        /* Oldest session is overwritten once the ring is full */
+        s = &sessions[session_next];
+        session_next = (session_next + 1) % PT_SESSIONS;
+        *s = (struct pt_session){.conn = conn, .used = true, .reason = -1};
+    } else {
+        s = session_find(conn);
+    }
+
+    if (s && !(s->marks & BIT(mark))) {
+        s->cycles[mark] = now;
+        s->marks |= BIT(mark);
+    }
+    k_spin_unlock(&pt_lock, key);
+}
+
+void pair_timeline_result(struct bt_conn *conn, int reason)
+{
+    pair_timeline_mark(conn, PT_MARK_PAIRING_DONE);
+
+    k_spinlock_key_t key = k_spin_lock(&pt_lock);
+    struct pt_session *s = session_find(conn);
+
+    if (s) {
+        s->reason = (int8_t)reason;
+    }
+    k_spin_unlock(&pt_lock, key);
+}
+
+void pair_timeline_close(struct bt_conn *conn)
+{
+    k_spinlock_key_t key = k_spin_lock(&pt_lock);
+    struct pt_session *s = session_find(conn);
+
+    if (s) {
+        s->conn = NULL;
+    }
+    k_spin_unlock(&pt_lock, key);
+}
+
+void pair_timeline_stats(struct pt_phase_stats stats[PT_PHASE_COUNT])
+{
+    uint64_t sum[PT_PHASE_COUNT] = {0};
+
+    for (size_t p = 0; p < PT_PHASE_COUNT; p++) {
+        stats[p] = (struct pt_phase_stats){.min_us = UINT32_MAX};
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&pt_lock);
+    for (size_t i = 0; i < PT_SESSIONS; i++) {
+        if (!sessions[i].used) {
+            continue;
+        }
+        for (size_t p = 0; p < PT_PHASE_COUNT; p++) {
+            uint32_t us;
+
+            if (phase_us(&sessions[i], &phase_defs[p], &us)) {
+                stats[p].min_us = MIN(stats[p].min_us, us);
+                stats[p].max_us = MAX(stats[p].max_us, us);
+                stats[p].count++;
+                sum[p] += us;
+            }
+        }
+    }
+    k_spin_unlock(&pt_lock, key);
+
+    for (size_t p = 0; p < PT_PHASE_COUNT; p++) {
+        if (stats[p].count) {
+            stats[p].avg_us = (uint32_t)(sum[p] / stats[p].count);
+        } else {
+            stats[p].min_us = 0;
+        }
+    }
+}
+
+/* --------------------------------------------------------------------------
+ * Diagnostic GATT Service
+ * -------------------------------------------------------------------------- */
+#define BT_UUID_PAIR_DIAG_SERVICE_VAL \
+    BT_UUID_128_ENCODE(0x12345678, 0x1234, 0x5678, 0x1234, 0x56789abcdf00)
+#define BT_UUID_PAIR_DIAG_STATS_CHAR_VAL \
+    BT_UUID_128_ENCODE(0x12345678, 0x1234, 0x5678, 0x1234, 0x56789abcdf01)
+
+#define BT_UUID_PAIR_DIAG_SERVICE    BT_UUID_DECLARE_128(BT_UUID_PAIR_DIAG_SERVICE_VAL)
+#define BT_UUID_PAIR_DIAG_STATS_CHAR BT_UUID_DECLARE_128(BT_UUID_PAIR_DIAG_STATS_CHAR_VAL)
+
+/* Value layout: PT_PHASE_COUNT x {min_us, avg_us, max_us (u32 LE), count (u16 LE)} */
+static ssize_t read_pair_stats(struct bt_conn *conn,
+                               const struct bt_gatt_attr *attr,
+                               void *buf, uint16_t len, uint16_t offset)
+{
+    /* A long read continues from the snapshot taken at offset 0 */
+    static struct pt_phase_stats stats[PT_PHASE_COUNT];
+
+    if (offset == 0) {
+        pair_timeline_mark(conn, PT_MARK_FIRST_GATT);
+        pair_timeline_stats(stats);
+
+        for (size_t p = 0; p < PT_PHASE_COUNT; p++) {
+            stats[p].min_us = sys_cpu_to_le32(stats[p].min_us);
+            stats[p].avg_us = sys_cpu_to_le32(stats[p].avg_us);
+            stats[p].max_us = sys_cpu_to_le32(stats[p].max_us);
+            stats[p].count  = sys_cpu_to_le16(stats[p].count);
+        }
+    }
+
+    return bt_gatt_attr_read(conn, attr, buf, len, offset, stats, sizeof(stats));
+}
+
+BT_GATT_SERVICE_DEFINE(pair_diag_svc,
+    BT_GATT_PRIMARY_SERVICE(BT_UUID_PAIR_DIAG_SERVICE),
+    BT_GATT_CHARACTERISTIC(BT_UUID_PAIR_DIAG_STATS_CHAR,
+                           BT_GATT_CHRC_READ,
+                           BT_GATT_PERM_READ_AUTHEN,
+                           read_pair_stats, NULL, NULL),
+);
+
+/* --------------------------------------------------------------------------
+ * Shell Commands
+ * -------------------------------------------------------------------------- */
+#ifdef CONFIG_SHELL
+static int cmd_pair_stats(const struct shell *sh, size_t argc, char **argv)
+{
+    struct pt_phase_stats stats[PT_PHASE_COUNT];
+
+    pair_timeline_stats(stats);
+
+    shell_print(sh, "%-8s %6s %10s %10s %10s", "phase", "n",
+                "min[us]", "avg[us]", "max[us]");
+    for (size_t p = 0; p < PT_PHASE_COUNT; p++) {
+        shell_print(sh, "%-8s %6u %10u %10u %10u", phase_defs[p].name,
+                    stats[p].count, stats[p].min_us, stats[p].avg_us,
+                    stats[p].max_us);
+    }
+    return 0;
+}
+
+static int cmd_pair_sessions(const struct shell *sh, size_t argc, char **argv)
+{
+    k_spinlock_key_t key = k_spin_lock(&pt_lock);
+    uint8_t first = session_next;
+
+    k_spin_unlock(&pt_lock, key);
+
+    for (size_t n = 0; n < PT_SESSIONS; n++) {
+        /* Oldest first */
+        size_t i = (first + n) % PT_SESSIONS;
+        struct pt_session s;
+
+        key = k_spin_lock(&pt_lock);
+        s = sessions[i];
+        k_spin_unlock(&pt_lock, key);
+
+        if (!s.used) {
+            continue;
+        }
+
+        shell_fprintf(sh, SHELL_NORMAL, "#%u %s reason %d:", (unsigned int)i,
+                      s.conn ? "open  " : "closed", s.reason);
+        for (size_t p = 0; p < PT_PHASE_COUNT; p++) {
+            uint32_t us;
+
+            if (phase_us(&s, &phase_defs[p], &us)) {
+                shell_fprintf(sh, SHELL_NORMAL, " %s=%u", phase_defs[p].name, us);
+            }
+        }
+        shell_fprintf(sh, SHELL_NORMAL, "\n");
+    }
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(pair_cmds,
+    SHELL_CMD(stats, NULL, "Per-phase pairing latency (min/avg/max)", cmd_pair_stats),
+    SHELL_CMD(sessions, NULL, "Phase breakdown of recorded sessions", cmd_pair_sessions),
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(pair, &pair_cmds, "Pairing timeline", NULL);
+#endif /* CONFIG_SHELL */
@@ -0,0 +1,85 @@
+/**
+ * @file pair_timeline.h
+ * @brief Pairing pipeline timeline recorder
+ *
+ * Timestamps each step of a pairing session with the hardware cycle counter
+ * and keeps the last CONFIG_APP_PAIR_TIMELINE_SESSIONS sessions. Per-phase
+ * min/avg/max latency is reported over the shell (`pair stats`) and through
+ * an authenticated diagnostic GATT characteristic.
+ */
+
+#ifndef PAIR_TIMELINE_H
+#define PAIR_TIMELINE_H
+
+#include <stdint.h>
+
+#include <zephyr/bluetooth/conn.h>
+
+/* --------------------------------------------------------------------------
+ * Types
+ * -------------------------------------------------------------------------- */
+typedef enum {
+    PT_MARK_CONNECTED = 0,  /* connected() callback */
+    PT_MARK_SEC_REQUEST,    /* bt_conn_set_security() issued */
+    PT_MARK_PASSKEY,        /* passkey displayed / confirmed */
+    PT_MARK_SECURITY,       /* security_changed() callback */
+    PT_MARK_PAIRING_DONE,   /* pairing_complete() or pairing_failed() */
+    PT_MARK_FIRST_GATT,     /* first authenticated GATT access */
+    PT_MARK_COUNT,
+} pt_mark_t;
+
+typedef enum {
+    PT_PHASE_SEC_REQUEST = 0, /* connected -> security requested */
+    PT_PHASE_PASSKEY,         /* security requested -> passkey shown */
+    PT_PHASE_USER,            /* passkey shown -> link encrypted */
+    PT_PHASE_PAIRING,         /* passkey shown -> pairing done */
+    PT_PHASE_GATT,            /* pairing done -> first GATT access */
+    PT_PHASE_TOTAL,           /* connected -> first GATT access */
+    PT_PHASE_COUNT,
+} pt_phase_t;
+
+/* Latency summary of one phase, microseconds */
+struct pt_phase_stats {
+    uint32_t min_us;
+    uint32_t avg_us;
+    uint32_t max_us;
+    uint16_t count;
+} __packed;
+
+/* --------------------------------------------------------------------------
+ * Public Functions
+ * -------------------------------------------------------------------------- */
+/**
+ * @brief Record a timeline mark for the session belonging to conn
+ *
+ * PT_MARK_CONNECTED opens a new session, later marks are ignored if no
+ * session is open for conn. Only the first occurrence of a mark is kept.
+ *
+ * @param [in] conn The connection the event belongs to
+ * @param [in] mark Which step of the pipeline was reached
+ */
+void pair_timeline_mark(struct bt_conn *conn, pt_mark_t mark);
+
+/**
+ * @brief Record the outcome of pairing and stamp PT_MARK_PAIRING_DONE
+ *
+ * @param [in] conn   The connection that finished pairing
+ * @param [in] reason 0 on success, enum bt_security_err otherwise
+ */
+void pair_timeline_result(struct bt_conn *conn, int reason);
+
+/**
+ * @brief Close the session belonging to conn
+ *
+ * @param [in] conn The connection that went away
+ */
+void pair_timeline_close(struct bt_conn *conn);
+
+/**
+ * @brief Compute per-phase latency over all recorded sessions
+ *
+ * @param [out] stats Array of PT_PHASE_COUNT entries
+ */
+void pair_timeline_stats(struct pt_phase_stats stats[PT_PHASE_COUNT]);
+
+#endif /* PAIR_TIMELINE_H */
@@ -0,0 +1,160 @@
+/**
+ * @file power.c
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/zbus/zbus.h>
+
+#ifdef CONFIG_SHELL
+#include <zephyr/shell/shell.h>
+#endif
+
+#include "LED.h"
+
+#include "events.h"
+#include "power.h"
+
+LOG_MODULE_REGISTER(power, CONFIG_APP_LOG_LEVEL);
+
+/* --------------------------------------------------------------------------
+ * Constants
+ * -------------------------------------------------------------------------- */
+#define PWR_IDLE_TIMEOUT K_SECONDS(CONFIG_APP_POWER_IDLE_TIMEOUT_S)
+
+/* --------------------------------------------------------------------------
+ * Global States
+ * -------------------------------------------------------------------------- */
+static const char *const pwr_state_names[PWR_STATE_COUNT] = {
+    [PWR_STATE_ACTIVE]  = "active",
+    [PWR_STATE_BLANKED] = "blanked",
+};
+
+/* State only changes from the system workqueue, the lock covers readers */
+static struct k_spinlock pwr_lock;
+static pwr_state_t       pwr_state = PWR_STATE_ACTIVE;
+static int64_t           pwr_entered_ms;
+static uint64_t          pwr_time_ms[PWR_STATE_COUNT];
+static uint32_t          pwr_entries[PWR_STATE_COUNT] = {[PWR_STATE_ACTIVE] = 1};
+
+static struct k_work_delayable pwr_idle_work;
+static struct k_work           pwr_wake_work;
+
+/* --------------------------------------------------------------------------
+ * Private Functions
+ * -------------------------------------------------------------------------- */
+static void pwr_enter(pwr_state_t state)
+{
+    int64_t now = k_uptime_get();
+    k_spinlock_key_t key = k_spin_lock(&pwr_lock);
+
+    pwr_time_ms[pwr_state] += now - pwr_entered_ms;
+    pwr_entered_ms = now;
+    pwr_state = state;
+    pwr_entries[state]++;
+    k_spin_unlock(&pwr_lock, key);
+
+    struct pwr_evt evt = {.state = state};
+
+    evt_publish(&pwr_chan, &evt);
+    LOG_INF("[PWR] %s", pwr_state_names[state]);
+}
+
+static void pwr_idle_handler(struct k_work *work)
+{
+    if (pwr_state != PWR_STATE_ACTIVE) {
+        return;
+    }
+    LED_suspend();
+    pwr_enter(PWR_STATE_BLANKED);
+}
+
+static void pwr_wake_handler(struct k_work *work)
+{
+    if (pwr_state == PWR_STATE_BLANKED) {
+        LED_resume();
+        pwr_enter(PWR_STATE_ACTIVE);
+    }
+    k_work_reschedule(&pwr_idle_work, PWR_IDLE_TIMEOUT);
+}
+
+/* Runs in the publisher's context: only hand over to the workqueue */
+static void pwr_activity(const struct zbus_channel *chan)
+{
+    k_work_submit(&pwr_wake_work);
+}
+
+ZBUS_LISTENER_DEFINE(pwr_lis, pwr_activity);
+ZBUS_CHAN_ADD_OBS(btn_chan, pwr_lis, 0);
+ZBUS_CHAN_ADD_OBS(conn_chan, pwr_lis, 0);
+ZBUS_CHAN_ADD_OBS(sec_chan, pwr_lis, 0);
+ZBUS_CHAN_ADD_OBS(dfu_chan, pwr_lis, 0);
+
+/* --------------------------------------------------------------------------
+ * Public Functions
+ * -------------------------------------------------------------------------- */
+pwr_state_t power_state_get(void)
+{
+    return pwr_state;
+}
+
+void power_stats_get(struct pwr_stats *out)
+{
+    k_spinlock_key_t key = k_spin_lock(&pwr_lock);
+
+    for (size_t i = 0; i < PWR_STATE_COUNT; i++) {
+        out->time_ms[i] = pwr_time_ms[i];
+        out->entries[i] = pwr_entries[i];
+    }
+    out->time_ms[pwr_state] += k_uptime_get() - pwr_entered_ms;
+    k_spin_unlock(&pwr_lock, key);
+}
+
+static int power_init(void)
+{
+    k_work_init_delayable(&pwr_idle_work, pwr_idle_handler);
+    k_work_init(&pwr_wake_work, pwr_wake_handler);
+    k_work_schedule(&pwr_idle_work, PWR_IDLE_TIMEOUT);
+    return 0;
+}
+
+SYS_INIT(power_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+/* --------------------------------------------------------------------------
+ * Shell Commands
+ * -------------------------------------------------------------------------- */
+#ifdef CONFIG_SHELL
+static int cmd_power_stats(const struct shell *sh, size_t argc, char **argv)
+{
+    struct pwr_stats st;
+    uint64_t total = 0;
+
+    power_stats_get(&st);
+    for (size_t i = 0; i < PWR_STATE_COUNT; i++) {
+        total += st.time_ms[i];
+    }
+
+    shell_print(sh, "%-8s %8s %12s %6s", "state", "entries", "time[ms]", "[%]");
+    for (size_t i = 0; i < PWR_STATE_COUNT; i++) {
+        shell_print(sh, "%-8s %8u %12llu %6u", pwr_state_names[i], st.entries[i],
+                    st.time_ms[i],
+                    total ? (uint32_t)((st.time_ms[i] * 100U) / total) : 0U);
+    }
+    return 0;
+}
+
+static int cmd_power_blank(const struct shell *sh, size_t argc, char **argv)
+{
+    k_work_reschedule(&pwr_idle_work, K_NO_WAIT);
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(power_cmds,
+    SHELL_CMD(stats, NULL, "Time spent in each power state", cmd_power_stats),
+    SHELL_CMD(blank, NULL, "Enter the blanked state now", cmd_power_blank),
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(power, &power_cmds, "Power manager", NULL);
+#endif /* CONFIG_SHELL */
@@ -0,0 +1,48 @@
+/**
+ * @file power.h
+ * @brief Idle power manager for the display and LEDs
+ *
+ * After CONFIG_APP_POWER_IDLE_TIMEOUT_S without button, connection,
+ * security or firmware update events the LEDs are suspended and a BLANKED state is published
+ * on pwr_chan, on which the UI blanks and releases the display. The next
+ * event wakes both and the UI redraws its current state. Time spent in
+ * each state is kept as an average-current proxy.
+ */
+
+#ifndef POWER_H
+#define POWER_H
+
+#include <stdint.h>
+
+/* --------------------------------------------------------------------------
+ * Types
+ * -------------------------------------------------------------------------- */
+typedef enum {
+    PWR_STATE_ACTIVE = 0, /* display on, LEDs driven */
+    PWR_STATE_BLANKED,    /* display blanked and suspended, LED PWM off */
+    PWR_STATE_COUNT,
+} pwr_state_t;
+
+struct pwr_stats {
+    uint64_t time_ms[PWR_STATE_COUNT]; /* including the ongoing state */
+    uint32_t entries[PWR_STATE_COUNT];
+};
+
+/* --------------------------------------------------------------------------
+ * Public Functions
+ * -------------------------------------------------------------------------- */
+/**
+ * @brief Get the current power state
+ *
+ * @return The current state
+ */
+pwr_state_t power_state_get(void);
+
+/**
+ * @brief Copy the time spent in and number of entries into each state
+ *
+ * @param [out] out Destination
+ */
+void power_stats_get(struct pwr_stats *out);
+
+#endif /* POWER_H */
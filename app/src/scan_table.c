@@ -0,0 +1,191 @@
+/**
+ * @file scan_table.c
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/bluetooth/gap.h>
+
+#include "scan_table.h"
+#include "secure_svc.h"
+
+/* --------------------------------------------------------------------------
+ * Constants
+ * -------------------------------------------------------------------------- */
+#define SCAN_TABLE_SIZE  CONFIG_APP_SCAN_TABLE_SIZE
+#define SCAN_TABLE_MASK  (SCAN_TABLE_SIZE - 1)
+#define SCAN_PROBE_MAX   CONFIG_APP_SCAN_TABLE_PROBE_MAX
+#define SCAN_STALE_MS    CONFIG_APP_SCAN_TABLE_STALE_MS
+
+#define SCAN_UUID128_LEN 16
+
+BUILD_ASSERT(IS_POWER_OF_TWO(SCAN_TABLE_SIZE), "APP_SCAN_TABLE_SIZE must be a power of two");
+BUILD_ASSERT(SCAN_PROBE_MAX <= SCAN_TABLE_SIZE, "probe window larger than the table");
+
+/* --------------------------------------------------------------------------
+ * Global States
+ * -------------------------------------------------------------------------- */
+/* Little endian, as it appears in AD data */
+static const uint8_t scan_uuid[SCAN_UUID128_LEN] = {BT_UUID_SECURE_DEMO_SERVICE_VAL};
+
+static struct k_spinlock  scan_lock;
+static struct scan_entry  scan_table[SCAN_TABLE_SIZE];
+static struct scan_stats  scan_stats;
+static bool               scan_filter = IS_ENABLED(CONFIG_APP_SCAN_TABLE_FILTER_UUID);
+
+/* --------------------------------------------------------------------------
+ * Private Functions
+ * -------------------------------------------------------------------------- */
+/* FNV-1a over type and address */
+static uint32_t scan_hash(const bt_addr_le_t *addr)
+{
+    uint32_t h = 2166136261U ^ addr->type;
+
+    h *= 16777619U;
+    for (size_t i = 0; i < sizeof(addr->a.val); i++) {
+        h = (h ^ addr->a.val[i]) * 16777619U;
+    }
+    return h ^ (h >> 16);
+}
+
+/* --------------------------------------------------------------------------
+ * Public Functions
+ * -------------------------------------------------------------------------- */
+bool scan_ad_has_uuid(const uint8_t *ad, uint8_t len)
+{
+    while (len >= 2) {
+        uint8_t field = ad[0];
+
+        if (field == 0 || field >= len) {
+            return false;
+        }
+        if (ad[1] == BT_DATA_UUID128_ALL || ad[1] == BT_DATA_UUID128_SOME) {
+            for (const uint8_t *u = &ad[2]; u + SCAN_UUID128_LEN <= &ad[1 + field];
+                 u += SCAN_UUID128_LEN) {
+                /* First byte rejects almost every foreign UUID */
+                if (u[0] == scan_uuid[0] && !memcmp(u, scan_uuid, SCAN_UUID128_LEN)) {
+                    return true;
+                }
+            }
+        }
+        ad  += field + 1;
+        len -= field + 1;
+    }
+    return false;
+}
+
+int scan_table_report(const bt_addr_le_t *addr, int8_t rssi, const uint8_t *ad, uint8_t len)
+{
+    uint32_t start = k_cycle_get_32();
+    uint32_t now = k_uptime_get_32();
+    bool match = scan_ad_has_uuid(ad, len);
+    uint32_t idx = scan_hash(addr) & SCAN_TABLE_MASK;
+    struct scan_entry *slot = NULL;
+    struct scan_entry *oldest = NULL;
+    uint32_t probes = 0;
+    int ret = 0;
+    k_spinlock_key_t key = k_spin_lock(&scan_lock);
+
+    scan_stats.reports++;
+    if (scan_filter && !match) {
+        scan_stats.filtered++;
+        ret = -ENOENT;
+        goto out;
+    }
+
+    /* Entries are never deleted, so an empty slot ends the search */
+    for (; probes < SCAN_PROBE_MAX; probes++) {
+        struct scan_entry *e = &scan_table[(idx + probes) & SCAN_TABLE_MASK];
+
+        if (!e->used || bt_addr_le_eq(&e->addr, addr)) {
+            slot = e;
+            break;
+        }
+        if (!oldest || (int32_t)(e->last_ms - oldest->last_ms) < 0) {
+            oldest = e;
+        }
+    }
+    /* A hit stops the loop before counting its own probe */
+    scan_stats.probes_max = MAX(scan_stats.probes_max, slot ? probes + 1 : probes);
+
+    if (!slot) {
+        if ((now - oldest->last_ms) < SCAN_STALE_MS) {
+            scan_stats.dropped++;
+            ret = -ENOSPC;
+            goto out;
+        }
+        slot = oldest;
+        slot->used = false;
+        scan_stats.evicted++;
+    }
+
+    if (!slot->used) {
+        *slot = (struct scan_entry){.addr = *addr, .used = true, .rssi_max = rssi};
+        scan_stats.new_devices++;
+    }
+    slot->rssi     = rssi;
+    slot->rssi_max = MAX(slot->rssi_max, rssi);
+    slot->match    = match;
+    slot->last_ms  = now;
+    if (slot->reports < UINT16_MAX) {
+        slot->reports++;
+    }
+
+out:
+    scan_stats.cycles += k_cycle_get_32() - start;
+    k_spin_unlock(&scan_lock, key);
+    return ret;
+}
+
+void scan_table_filter_set(bool enable)
+{
+    scan_filter = enable;
+}
+
+size_t scan_table_top(struct scan_entry *out, size_t max)
+{
+    uint32_t now = k_uptime_get_32();
+    size_t n = 0;
+    k_spinlock_key_t key = k_spin_lock(&scan_lock);
+
+    /* Insertion into a short sorted array: max is a handful of rows */
+    for (size_t i = 0; i < SCAN_TABLE_SIZE && max; i++) {
+        const struct scan_entry *e = &scan_table[i];
+
+        if (!e->used || (now - e->last_ms) >= SCAN_STALE_MS) {
+            continue;
+        }
+        if (n == max && e->rssi <= out[n - 1].rssi) {
+            continue;
+        }
+
+        size_t j = (n < max) ? n++ : n - 1;
+
+        while (j > 0 && out[j - 1].rssi < e->rssi) {
+            out[j] = out[j - 1];
+            j--;
+        }
+        out[j] = *e;
+    }
+    k_spin_unlock(&scan_lock, key);
+    return n;
+}
+
+void scan_table_stats_get(struct scan_stats *out)
+{
+    k_spinlock_key_t key = k_spin_lock(&scan_lock);
+
+    *out = scan_stats;
+    k_spin_unlock(&scan_lock, key);
+}
+
+void scan_table_reset(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&scan_lock);
+
+    memset(scan_table, 0, sizeof(scan_table));
+    scan_stats = (struct scan_stats){.since_ms = k_uptime_get_32()};
+    k_spin_unlock(&scan_lock, key);
+}
@@ -0,0 +1,100 @@
+/**
+ * @file scan_table.h
+ * @brief Advertiser dedup table and service UUID matcher for the scanner
+ *
+ * A fixed-size, open-addressed (linear probing) hash table keyed by the
+ * advertiser address keeps one entry per device. Entries are never deleted;
+ * a new device reuses the stalest slot of its probe window once that slot
+ * has not been heard for CONFIG_APP_SCAN_TABLE_STALE_MS, otherwise its
+ * report is dropped. No BT stack dependency, so it can be driven with
+ * synthetic reports.
+ */
+
+#ifndef SCAN_TABLE_H
+#define SCAN_TABLE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <zephyr/bluetooth/addr.h>
+
+/* --------------------------------------------------------------------------
+ * Types
+ * -------------------------------------------------------------------------- */
+struct scan_entry {
+    bt_addr_le_t addr;
+    int8_t       rssi;      /* last report */
+    int8_t       rssi_max;
+    bool         used;
+    bool         match;     /* advertises the filtered service UUID */
+    uint16_t     reports;   /* saturating */
+    uint32_t     last_ms;   /* uptime of the last report */
+};
+
+struct scan_stats {
+    uint32_t reports;       /* scan_table_report() calls */
+    uint32_t filtered;      /* rejected by the UUID filter */
+    uint32_t new_devices;
+    uint32_t evicted;       /* stale entries replaced */
+    uint32_t dropped;       /* no usable slot in the probe window */
+    uint32_t probes_max;
+    uint64_t cycles;        /* total time spent in scan_table_report() */
+    uint32_t since_ms;      /* uptime of the last reset */
+};
+
+/* --------------------------------------------------------------------------
+ * Public Functions
+ * -------------------------------------------------------------------------- */
+/**
+ * @brief Check an advertising payload for the secure demo service UUID
+ *
+ * @param [in] ad  Raw AD structures
+ * @param [in] len Length of ad
+ *
+ * @return true if a complete or incomplete 128-bit UUID list contains it
+ */
+bool scan_ad_has_uuid(const uint8_t *ad, uint8_t len);
+
+/**
+ * @brief Account one advertising report
+ *
+ * @param [in] addr Advertiser address
+ * @param [in] rssi Report RSSI
+ * @param [in] ad   Raw AD structures
+ * @param [in] len  Length of ad
+ *
+ * @return 0 if recorded, -ENOENT if filtered, -ENOSPC if dropped
+ */
+int scan_table_report(const bt_addr_le_t *addr, int8_t rssi, const uint8_t *ad, uint8_t len);
+
+/**
+ * @brief Only record devices that advertise the service UUID
+ *
+ * @param [in] enable true to filter
+ */
+void scan_table_filter_set(bool enable);
+
+/**
+ * @brief Copy the strongest recently heard devices, strongest first
+ *
+ * @param [out] out Destination array
+ * @param [in]  max Number of entries out can hold
+ *
+ * @return Number of entries copied
+ */
+size_t scan_table_top(struct scan_entry *out, size_t max);
+
+/**
+ * @brief Copy the processing counters
+ *
+ * @param [out] out Destination
+ */
+void scan_table_stats_get(struct scan_stats *out);
+
+/**
+ * @brief Forget every device and clear the counters
+ */
+void scan_table_reset(void);
+
+#endif /* SCAN_TABLE_H */
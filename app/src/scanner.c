@@ -0,0 +1,149 @@
+/**
+ * @file scanner.c
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/gap.h>
+
+#ifdef CONFIG_SHELL
+#include <zephyr/shell/shell.h>
+#endif
+
+#include "scan_table.h"
+#include "scanner.h"
+
+LOG_MODULE_REGISTER(scanner, CONFIG_APP_LOG_LEVEL);
+
+/* --------------------------------------------------------------------------
+ * Constants
+ * -------------------------------------------------------------------------- */
+/* Passive, window == interval: the radio listens whenever it isn't
+ * advertising or serving a connection. No controller duplicate filter,
+ * the host table dedupes and keeps RSSI current. */
+#define SCAN_PARAM BT_LE_SCAN_PARAM(BT_LE_SCAN_TYPE_PASSIVE, BT_LE_SCAN_OPT_NONE, \
+                                    CONFIG_APP_SCANNER_INTERVAL, CONFIG_APP_SCANNER_INTERVAL)
+
+/* --------------------------------------------------------------------------
+ * Global States
+ * -------------------------------------------------------------------------- */
+static atomic_t scanner_running;
+
+/* --------------------------------------------------------------------------
+ * Private Functions
+ * -------------------------------------------------------------------------- */
+static void scanner_recv(const struct bt_le_scan_recv_info *info, struct net_buf_simple *buf)
+{
+    scan_table_report(info->addr, info->rssi, buf->data, (uint8_t)MIN(buf->len, UINT8_MAX));
+}
+
+static struct bt_le_scan_cb scanner_cb = {
+    .recv = scanner_recv,
+};
+
+/* --------------------------------------------------------------------------
+ * Public Functions
+ * -------------------------------------------------------------------------- */
+int scanner_start(void)
+{
+    static bool registered;
+
+    if (!registered) {
+        bt_le_scan_cb_register(&scanner_cb);
+        registered = true;
+    }
+    if (atomic_set(&scanner_running, 1)) {
+        return -EALREADY;
+    }
+    scan_table_reset();
+
+    int err = bt_le_scan_start(SCAN_PARAM, NULL);
+
+    if (err) {
+        atomic_clear(&scanner_running);
+        LOG_ERR("[SCAN] Start failed (err %d)", err);
+        return err;
+    }
+    LOG_INF("[SCAN] Scanning");
+    return 0;
+}
+
+int scanner_stop(void)
+{
+    if (!atomic_cas(&scanner_running, 1, 0)) {
+        return -EALREADY;
+    }
+    return bt_le_scan_stop();
+}
+
+bool scanner_is_running(void)
+{
+    return atomic_get(&scanner_running);
+}
+
+/* --------------------------------------------------------------------------
+ * Shell Commands
+ * -------------------------------------------------------------------------- */
+#ifdef CONFIG_SHELL
+static int cmd_scan_on(const struct shell *sh, size_t argc, char **argv)
+{
+    return scanner_start();
+}
+
+static int cmd_scan_off(const struct shell *sh, size_t argc, char **argv)
+{
+    return scanner_stop();
+}
+
+static int cmd_scan_filter(const struct shell *sh, size_t argc, char **argv)
+{
+    scan_table_filter_set(!strcmp(argv[1], "on"));
+    scan_table_reset();
+    return 0;
+}
+
+static int cmd_scan_top(const struct shell *sh, size_t argc, char **argv)
+{
+    struct scan_entry top[CONFIG_APP_SCANNER_TOP_N];
+    size_t n = scan_table_top(top, ARRAY_SIZE(top));
+
+    for (size_t i = 0; i < n; i++) {
+        char addr[BT_ADDR_LE_STR_LEN];
+
+        bt_addr_le_to_str(&top[i].addr, addr, sizeof(addr));
+        shell_print(sh, "%-30s %4d dBm (max %4d) %5u reports%s", addr, top[i].rssi,
+                    top[i].rssi_max, top[i].reports, top[i].match ? " *" : "");
+    }
+    return 0;
+}
+
+static int cmd_scan_stats(const struct shell *sh, size_t argc, char **argv)
+{
+    struct scan_stats st;
+
+    scan_table_stats_get(&st);
+
+    uint32_t ms = MAX(k_uptime_get_32() - st.since_ms, 1U);
+
+    shell_print(sh, "%u reports in %u ms (%u/s), %u ns/report", st.reports, ms,
+                (uint32_t)(((uint64_t)st.reports * MSEC_PER_SEC) / ms),
+                st.reports ? (uint32_t)(k_cyc_to_ns_floor64(st.cycles) / st.reports) : 0U);
+    shell_print(sh, "%u new, %u filtered, %u evicted, %u dropped, max %u probes",
+                st.new_devices, st.filtered, st.evicted, st.dropped, st.probes_max);
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(scan_cmds,
+    SHELL_CMD(on, NULL, "Start scanning", cmd_scan_on),
+    SHELL_CMD(off, NULL, "Stop scanning", cmd_scan_off),
+    SHELL_CMD_ARG(filter, NULL, "Service UUID filter <on|off>", cmd_scan_filter, 2, 0),
+    SHELL_CMD(top, NULL, "Strongest devices", cmd_scan_top),
+    SHELL_CMD(stats, NULL, "Report rate, evictions and drops", cmd_scan_stats),
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(scan, &scan_cmds, "Observer scan", NULL);
+#endif /* CONFIG_SHELL */
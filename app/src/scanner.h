@@ -0,0 +1,41 @@
+/**
+ * @file scanner.h
+ * @brief Observer role: high duty cycle passive scan into the dedup table
+ *
+ * Scanning runs alongside advertising. Every report goes through
+ * scan_table_report() in the BT RX context; the UI shows the strongest
+ * CONFIG_APP_SCANNER_TOP_N devices from scan_table_top().
+ */
+
+#ifndef SCANNER_H
+#define SCANNER_H
+
+#include <stdbool.h>
+
+/* --------------------------------------------------------------------------
+ * Public Functions
+ * -------------------------------------------------------------------------- */
+/**
+ * @brief Start scanning
+ *
+ * Call once the BT stack is ready.
+ *
+ * @return Error code, < 0 on failures
+ */
+int scanner_start(void);
+
+/**
+ * @brief Stop scanning, the table keeps its entries
+ *
+ * @return Error code, < 0 on failures
+ */
+int scanner_stop(void);
+
+/**
+ * @brief Check whether the scanner is running
+ *
+ * @return true if scanning
+ */
+bool scanner_is_running(void);
+
+#endif /* SCANNER_H */
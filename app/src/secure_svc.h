@@ -0,0 +1,37 @@
+/**
+ * @file secure_svc.h
+ * @brief UUIDs of the secure demo GATT service and the bulk L2CAP PSM
+ *
+ * Shared with the simulated central in bench/bsim_central.
+ */
+
+#ifndef SECURE_SVC_H
+#define SECURE_SVC_H
+
+#include <zephyr/bluetooth/uuid.h>
+
+/* --------------------------------------------------------------------------
+ * Custom UUIDs
+ * -------------------------------------------------------------------------- */
+#define BT_UUID_SECURE_DEMO_SERVICE_VAL \
+    BT_UUID_128_ENCODE(0x12345678, 0x1234, 0x5678, 0x1234, 0x56789abcdef0)
+#define BT_UUID_SECURE_READ_CHAR_VAL \
+    BT_UUID_128_ENCODE(0x12345678, 0x1234, 0x5678, 0x1234, 0x56789abcdef1)
+#define BT_UUID_SECURE_WRITE_CHAR_VAL \
+    BT_UUID_128_ENCODE(0x12345678, 0x1234, 0x5678, 0x1234, 0x56789abcdef2)
+#define BT_UUID_SECURE_GEN_CHAR_VAL \
+    BT_UUID_128_ENCODE(0x12345678, 0x1234, 0x5678, 0x1234, 0x56789abcdef3)
+
+#define BT_UUID_SECURE_DEMO_SERVICE  BT_UUID_DECLARE_128(BT_UUID_SECURE_DEMO_SERVICE_VAL)
+#define BT_UUID_SECURE_READ_CHAR     BT_UUID_DECLARE_128(BT_UUID_SECURE_READ_CHAR_VAL)
+#define BT_UUID_SECURE_WRITE_CHAR    BT_UUID_DECLARE_128(BT_UUID_SECURE_WRITE_CHAR_VAL)
+/* struct gatt_store_gen (src/gatt_store.h) */
+#define BT_UUID_SECURE_GEN_CHAR      BT_UUID_DECLARE_128(BT_UUID_SECURE_GEN_CHAR_VAL)
+
+/* Largest value accepted by the write characteristic */
+#define SECURE_WRITE_MAX_LEN 63
+
+/* LE credit-based channel of src/l2cap_bulk.c (dynamic PSM range) */
+#define SECURE_BULK_PSM 0x0080
+
+#endif /* SECURE_SVC_H */
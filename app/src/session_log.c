@@ -0,0 +1,481 @@
+/**
+ * @file session_log.c
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/zbus/zbus.h>
+
+#ifdef CONFIG_APP_SESSION_LOG_SD
+#include <zephyr/fs/fs.h>
+#include <zephyr/storage/disk_access.h>
+#include <ff.h>
+#endif
+
+#ifdef CONFIG_APP_SESSION_LOG_FLASH
+#include <zephyr/fs/fcb.h>
+#include <zephyr/storage/flash_map.h>
+#endif
+
+#ifdef CONFIG_SHELL
+#include <zephyr/shell/shell.h>
+#endif
+
+#include "events.h"
+#include "session_log.h"
+
+LOG_MODULE_REGISTER(session_log, CONFIG_APP_LOG_LEVEL);
+
+/* --------------------------------------------------------------------------
+ * Constants
+ * -------------------------------------------------------------------------- */
+#define SLOG_BLOCK        SESSION_LOG_BLOCK_SIZE
+#define SLOG_BLOCKS       CONFIG_APP_SESSION_LOG_BLOCKS
+#define SLOG_FLUSH_PERIOD K_MSEC(CONFIG_APP_SESSION_LOG_FLUSH_MS)
+
+#define SLOG_SD_DISK "SD" /* disk-name of the shield's sdmmc node */
+#define SLOG_SD_MNT  "/" SLOG_SD_DISK ":"
+#define SLOG_SD_PATH SLOG_SD_MNT "/SESSION.LOG"
+
+#define SLOG_PARTITION_ID FIXED_PARTITION_ID(session_log_partition)
+
+/* --------------------------------------------------------------------------
+ * Types
+ * -------------------------------------------------------------------------- */
+struct slog_block {
+    uint8_t  data[SLOG_BLOCK];
+    uint16_t used;
+    uint32_t sealed_cyc;  /* k_cycle_get_32() when it became ready to write */
+};
+
+/* --------------------------------------------------------------------------
+ * Global States
+ * -------------------------------------------------------------------------- */
+/* The block at slog_fill takes new records, the slog_sealed blocks before
+ * it wait for the writer, oldest first */
+static struct k_spinlock         slog_lock;
+static struct slog_block         slog_blocks[SLOG_BLOCKS];
+static size_t                    slog_fill;
+static size_t                    slog_sealed;
+static uint32_t                  slog_lost;   /* not yet reported in the log */
+static bool                      slog_off;    /* no storage found */
+static struct session_log_stats  slog_stats;
+static uint64_t                  slog_lat_sum_us;
+
+static K_SEM_DEFINE(slog_sem, 0, 1);
+static atomic_t slog_flush_req;
+
+#ifdef CONFIG_APP_SESSION_LOG_SD
+static FATFS             slog_fat;
+static struct fs_file_t  slog_file;
+static struct fs_mount_t slog_mnt = {
+    .type       = FS_FATFS,
+    .fs_data    = &slog_fat,
+    .mnt_point  = SLOG_SD_MNT,
+};
+#endif
+
+#ifdef CONFIG_APP_SESSION_LOG_FLASH
+static struct flash_sector slog_sectors[CONFIG_APP_SESSION_LOG_FLASH_SECTORS];
+static struct fcb          slog_fcb;
+
+/* The sector count is stored in struct fcb's uint8_t f_sector_cnt */
+BUILD_ASSERT(ARRAY_SIZE(slog_sectors) <= UINT8_MAX, "FCB holds at most 255 sectors");
+#endif
+
+/* --------------------------------------------------------------------------
+ * Private Functions
+ * -------------------------------------------------------------------------- */
+/* Called with slog_lock held */
+static void slog_seal(void)
+{
+    slog_blocks[slog_fill].sealed_cyc = k_cycle_get_32();
+    slog_sealed++;
+    slog_fill = (slog_fill + 1) % SLOG_BLOCKS;
+}
+
+/* Called with slog_lock held. Records never straddle two blocks. */
+static bool slog_put(uint8_t type, uint32_t now, const void *payload, uint8_t len, bool *sealed)
+{
+    struct slog_block *blk = &slog_blocks[slog_fill];
+    struct session_log_rec rec = {
+        .uptime_ms = sys_cpu_to_le32(now),
+        .type      = type,
+        .len       = len,
+    };
+
+    if (blk->used + sizeof(rec) + len > SLOG_BLOCK) {
+        /* Every other block is waiting for storage */
+        if (slog_sealed == SLOG_BLOCKS - 1) {
+            return false;
+        }
+        slog_seal();
+        *sealed = true;
+        blk = &slog_blocks[slog_fill];
+    }
+    memcpy(&blk->data[blk->used], &rec, sizeof(rec));
+    memcpy(&blk->data[blk->used + sizeof(rec)], payload, len);
+    blk->used += sizeof(rec) + len;
+    return true;
+}
+
+/* Any thread: only copies into RAM, the writer thread does the I/O */
+static void slog_append(session_log_type_t type, const void *payload, uint8_t len)
+{
+    uint32_t now = k_uptime_get_32();
+    bool sealed = false;
+    k_spinlock_key_t key = k_spin_lock(&slog_lock);
+
+    if (slog_off) {
+        k_spin_unlock(&slog_lock, key);
+        return;
+    }
+    if (slog_lost) {
+        uint32_t lost = sys_cpu_to_le32(slog_lost);
+
+        if (slog_put(SESSION_LOG_DROPPED, now, &lost, sizeof(lost), &sealed)) {
+            slog_lost = 0;
+        }
+    }
+    /* Behind a gap that couldn't be reported yet, drop to keep the order */
+    if (!slog_lost && slog_put(type, now, payload, len, &sealed)) {
+        slog_stats.records++;
+    } else {
+        slog_lost++;
+        slog_stats.dropped++;
+    }
+    k_spin_unlock(&slog_lock, key);
+
+    if (sealed) {
+        k_sem_give(&slog_sem);
+    }
+}
+
+#ifdef CONFIG_APP_SESSION_LOG_SD
+static int slog_sd_open(void)
+{
+    /* Fails right away without a card */
+    int err = disk_access_ioctl(SLOG_SD_DISK, DISK_IOCTL_CTRL_INIT, NULL);
+
+    if (err) {
+        return err;
+    }
+    err = fs_mount(&slog_mnt);
+    if (err) {
+        return err;
+    }
+
+    fs_file_t_init(&slog_file);
+    err = fs_open(&slog_file, SLOG_SD_PATH, FS_O_CREATE | FS_O_WRITE | FS_O_APPEND);
+    if (err) {
+        fs_unmount(&slog_mnt);
+        return err;
+    }
+
+    /* Keep every block on a sector boundary after an interrupted write */
+    static const uint8_t zeros[SLOG_BLOCK];
+    off_t size = 0;
+
+    if (!fs_seek(&slog_file, 0, FS_SEEK_END)) {
+        size = fs_tell(&slog_file);
+    }
+    if (size > 0 && size % SLOG_BLOCK) {
+        fs_write(&slog_file, zeros, SLOG_BLOCK - size % SLOG_BLOCK);
+    }
+    LOG_INF("Logging to " SLOG_SD_PATH " (%u bytes)", (uint32_t)MAX(size, 0));
+    return 0;
+}
+
+/* Whole sectors only, so the card never reads-modifies-writes */
+static int slog_sd_write(const struct slog_block *blk)
+{
+    ssize_t ret = fs_write(&slog_file, blk->data, SLOG_BLOCK);
+
+    if (ret < 0) {
+        return ret;
+    }
+    return (ret == SLOG_BLOCK) ? SLOG_BLOCK : -ENOSPC;
+}
+#endif /* CONFIG_APP_SESSION_LOG_SD */
+
+#ifdef CONFIG_APP_SESSION_LOG_FLASH
+static int slog_flash_open(void)
+{
+    uint32_t count = ARRAY_SIZE(slog_sectors);
+    int err = flash_area_get_sectors(SLOG_PARTITION_ID, &count, slog_sectors);
+
+    if (err) {
+        return err;
+    }
+    slog_fcb.f_magic       = SESSION_LOG_MAGIC;
+    slog_fcb.f_version     = SESSION_LOG_VERSION;
+    slog_fcb.f_sector_cnt  = count;
+    slog_fcb.f_scratch_cnt = 0;
+    slog_fcb.f_sectors     = slog_sectors;
+
+    err = fcb_init(SLOG_PARTITION_ID, &slog_fcb);
+    if (!err) {
+        LOG_INF("Logging to flash, %u sectors", count);
+    }
+    return err;
+}
+
+/* Only the used part: the partition isn't sector addressed, and a shorter
+ * entry delays the next erase */
+static int slog_flash_write(const struct slog_block *blk)
+{
+    struct fcb_entry loc;
+    int err = fcb_append(&slog_fcb, blk->used, &loc);
+
+    if (err == -ENOSPC) {
+        /* Full: erase the oldest sector, each is erased once per wrap */
+        err = fcb_rotate(&slog_fcb);
+        if (!err) {
+            err = fcb_append(&slog_fcb, blk->used, &loc);
+        }
+    }
+    if (!err) {
+        err = flash_area_write(slog_fcb.fap, FCB_ENTRY_FA_DATA_OFF(loc), blk->data, blk->used);
+    }
+    if (!err) {
+        err = fcb_append_finish(&slog_fcb, &loc);
+    }
+    return err ? err : blk->used;
+}
+#endif /* CONFIG_APP_SESSION_LOG_FLASH */
+
+static session_log_backend_t slog_open(void)
+{
+#ifdef CONFIG_APP_SESSION_LOG_SD
+    int err = slog_sd_open();
+
+    if (!err) {
+        return SESSION_LOG_BACKEND_SD;
+    }
+    LOG_INF("No SD card (err %d)", err);
+#endif
+#ifdef CONFIG_APP_SESSION_LOG_FLASH
+    if (!slog_flash_open()) {
+        return SESSION_LOG_BACKEND_FLASH;
+    }
+#endif
+    return SESSION_LOG_BACKEND_NONE;
+}
+
+static int slog_backend_write(session_log_backend_t backend, const struct slog_block *blk)
+{
+    switch (backend) {
+#ifdef CONFIG_APP_SESSION_LOG_SD
+    case SESSION_LOG_BACKEND_SD:
+        return slog_sd_write(blk);
+#endif
+#ifdef CONFIG_APP_SESSION_LOG_FLASH
+    case SESSION_LOG_BACKEND_FLASH:
+        return slog_flash_write(blk);
+#endif
+    default:
+        return -ENODEV;
+    }
+}
+
+static void slog_backend_sync(session_log_backend_t backend)
+{
+#ifdef CONFIG_APP_SESSION_LOG_SD
+    if (backend == SESSION_LOG_BACKEND_SD) {
+        /* Directory entry and FAT, once per round rather than per block */
+        fs_sync(&slog_file);
+    }
+#endif
+}
+
+/* One block per backend call: a display flush waiting for the shared SPI
+ * bus waits for at most one sector, and this thread runs below the UI */
+static void slog_write_sealed(session_log_backend_t backend)
+{
+    while (true) {
+        k_spinlock_key_t key = k_spin_lock(&slog_lock);
+        size_t waiting = slog_sealed;
+        size_t oldest = (slog_fill + SLOG_BLOCKS - waiting) % SLOG_BLOCKS;
+
+        k_spin_unlock(&slog_lock, key);
+        if (!waiting) {
+            break;
+        }
+
+        /* Sealed: producers don't touch it until slog_sealed drops */
+        struct slog_block *blk = &slog_blocks[oldest];
+        uint32_t start = k_cycle_get_32();
+        int ret = slog_backend_write(backend, blk);
+        uint32_t end = k_cycle_get_32();
+        uint32_t lat_us = k_cyc_to_us_floor32(end - blk->sealed_cyc);
+
+        memset(blk->data, 0, sizeof(blk->data));
+        blk->used = 0;
+
+        key = k_spin_lock(&slog_lock);
+        slog_sealed--;
+        if (ret < 0) {
+            slog_stats.write_errors++;
+        } else {
+            slog_stats.blocks++;
+            slog_stats.bytes     += ret;
+            slog_stats.write_us  += k_cyc_to_us_floor32(end - start);
+            slog_stats.lat_max_us = MAX(slog_stats.lat_max_us, lat_us);
+            slog_lat_sum_us      += lat_us;
+        }
+        k_spin_unlock(&slog_lock, key);
+
+        if (ret < 0) {
+            LOG_WRN("Block write failed (err %d)", ret);
+        }
+    }
+    slog_backend_sync(backend);
+}
+
+static void slog_bus_listener(const struct zbus_channel *chan)
+{
+    if (chan == &conn_chan) {
+        const struct conn_evt *evt = zbus_chan_const_msg(chan);
+        struct session_log_conn rec = {
+            .type      = evt->type,
+            .reason    = evt->reason,
+            .addr_type = evt->peer.type,
+        };
+
+        memcpy(rec.addr, evt->peer.a.val, sizeof(rec.addr));
+        slog_append(SESSION_LOG_CONN, &rec, sizeof(rec));
+        /* End of a session: make it durable without waiting */
+        if (evt->type == CONN_EVT_DISCONNECTED) {
+            session_log_flush();
+        }
+    } else if (chan == &sec_chan) {
+        const struct sec_evt *evt = zbus_chan_const_msg(chan);
+        struct session_log_sec rec = {
+            .type   = evt->type,
+            .level  = evt->level,
+            .err    = evt->err,
+            .bonded = evt->bonded,
+        };
+
+        slog_append(SESSION_LOG_SEC, &rec, sizeof(rec));
+    }
+}
+
+ZBUS_LISTENER_DEFINE(slog_lis, slog_bus_listener);
+ZBUS_CHAN_ADD_OBS(conn_chan, slog_lis, 0);
+ZBUS_CHAN_ADD_OBS(sec_chan, slog_lis, 0);
+
+/* Mounting and every write happen here, never on the BT threads */
+static void session_log_thread(void *p1, void *p2, void *p3)
+{
+    session_log_backend_t backend = slog_open();
+
+    if (backend == SESSION_LOG_BACKEND_NONE) {
+        k_spinlock_key_t key = k_spin_lock(&slog_lock);
+
+        slog_off = true;
+        k_spin_unlock(&slog_lock, key);
+        LOG_WRN("No storage, session log disabled");
+        return;
+    }
+
+    struct session_log_boot boot = {
+        .magic      = sys_cpu_to_le32(SESSION_LOG_MAGIC),
+        .version    = SESSION_LOG_VERSION,
+        .backend    = backend,
+        .block_size = sys_cpu_to_le16(SLOG_BLOCK),
+    };
+
+    slog_stats.backend = backend;
+    slog_append(SESSION_LOG_BOOT, &boot, sizeof(boot));
+
+    while (true) {
+        bool idle = k_sem_take(&slog_sem, SLOG_FLUSH_PERIOD) == -EAGAIN;
+
+        /* Nothing filled a block for a while, or a flush was requested */
+        if (idle || atomic_clear(&slog_flush_req)) {
+            k_spinlock_key_t key = k_spin_lock(&slog_lock);
+
+            if (slog_blocks[slog_fill].used && slog_sealed < SLOG_BLOCKS - 1) {
+                slog_seal();
+            }
+            k_spin_unlock(&slog_lock, key);
+        }
+        slog_write_sealed(backend);
+    }
+}
+
+K_THREAD_DEFINE(session_log, CONFIG_APP_SESSION_LOG_STACK_SIZE, session_log_thread,
+                NULL, NULL, NULL, CONFIG_APP_SESSION_LOG_PRIORITY, 0, 0);
+
+/* --------------------------------------------------------------------------
+ * Public Functions
+ * -------------------------------------------------------------------------- */
+void session_log_gatt_write(uint16_t handle, uint16_t offset, uint16_t len)
+{
+    struct session_log_gatt_write rec = {
+        .handle = sys_cpu_to_le16(handle),
+        .offset = sys_cpu_to_le16(offset),
+        .len    = sys_cpu_to_le16(len),
+    };
+
+    slog_append(SESSION_LOG_GATT_WRITE, &rec, sizeof(rec));
+}
+
+void session_log_flush(void)
+{
+    atomic_set(&slog_flush_req, 1);
+    k_sem_give(&slog_sem);
+}
+
+void session_log_stats_get(struct session_log_stats *out)
+{
+    k_spinlock_key_t key = k_spin_lock(&slog_lock);
+
+    *out = slog_stats;
+    out->lat_avg_us = slog_stats.blocks ? (uint32_t)(slog_lat_sum_us / slog_stats.blocks) : 0;
+    k_spin_unlock(&slog_lock, key);
+}
+
+/* --------------------------------------------------------------------------
+ * Shell Commands
+ * -------------------------------------------------------------------------- */
+#ifdef CONFIG_SHELL
+static const char *const slog_backend_names[] = {
+    [SESSION_LOG_BACKEND_NONE]  = "none",
+    [SESSION_LOG_BACKEND_SD]    = "SD " SLOG_SD_PATH,
+    [SESSION_LOG_BACKEND_FLASH] = "flash",
+};
+
+static int cmd_slog_stats(const struct shell *sh, size_t argc, char **argv)
+{
+    struct session_log_stats st;
+
+    session_log_stats_get(&st);
+    shell_print(sh, "Backend %s: %u records, %u dropped", slog_backend_names[st.backend],
+                st.records, st.dropped);
+    shell_print(sh, "%u blocks, %u bytes in %u ms (%u B/s), %u write errors", st.blocks,
+                st.bytes, st.write_us / USEC_PER_MSEC,
+                st.write_us ? (uint32_t)(((uint64_t)st.bytes * USEC_PER_SEC) / st.write_us) : 0U,
+                st.write_errors);
+    shell_print(sh, "Flush latency avg %u us, max %u us", st.lat_avg_us, st.lat_max_us);
+    return 0;
+}
+
+static int cmd_slog_flush(const struct shell *sh, size_t argc, char **argv)
+{
+    session_log_flush();
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(slog_cmds,
+    SHELL_CMD(stats, NULL, "Records, write throughput and flush latency", cmd_slog_stats),
+    SHELL_CMD(flush, NULL, "Write out the partial block", cmd_slog_flush),
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(slog, &slog_cmds, "Session log", NULL);
+#endif /* CONFIG_SHELL */
@@ -0,0 +1,118 @@
+/**
+ * @file session_log.h
+ * @brief Persistent log of connection, pairing and GATT write events
+ *
+ * Records are appended to RAM blocks of SESSION_LOG_BLOCK_SIZE bytes from
+ * whatever thread produced the event and written out whole by a low-priority
+ * thread, so the BT threads never touch storage. Blocks go to SESSION.LOG on
+ * the shield's micro-SD card, or to the flash circular buffer on the
+ * session_log_partition when no card is present.
+ *
+ * A block holds whole records, each a struct session_log_rec followed by len
+ * payload bytes, little endian. A record of type SESSION_LOG_PAD (a zero
+ * byte) ends the block early.
+ */
+
+#ifndef SESSION_LOG_H
+#define SESSION_LOG_H
+
+#include <stdint.h>
+
+#include <zephyr/toolchain.h>
+
+/* --------------------------------------------------------------------------
+ * Constants
+ * -------------------------------------------------------------------------- */
+#define SESSION_LOG_MAGIC      0x474F4C53 /* "SLOG" */
+#define SESSION_LOG_VERSION    1
+#define SESSION_LOG_BLOCK_SIZE 512        /* one SD sector */
+
+/* --------------------------------------------------------------------------
+ * Types
+ * -------------------------------------------------------------------------- */
+typedef enum {
+    SESSION_LOG_PAD = 0,    /* rest of the block is unused */
+    SESSION_LOG_BOOT,       /* struct session_log_boot */
+    SESSION_LOG_CONN,       /* struct session_log_conn */
+    SESSION_LOG_SEC,        /* struct session_log_sec */
+    SESSION_LOG_GATT_WRITE, /* struct session_log_gatt_write */
+    SESSION_LOG_DROPPED,    /* uint32_t records lost before this one */
+} session_log_type_t;
+
+typedef enum {
+    SESSION_LOG_BACKEND_NONE = 0,
+    SESSION_LOG_BACKEND_SD,
+    SESSION_LOG_BACKEND_FLASH,
+} session_log_backend_t;
+
+struct session_log_rec {
+    uint32_t uptime_ms;
+    uint8_t  type;      /* session_log_type_t */
+    uint8_t  len;       /* payload bytes that follow */
+} __packed;
+
+struct session_log_boot {
+    uint32_t magic;
+    uint8_t  version;
+    uint8_t  backend;   /* session_log_backend_t */
+    uint16_t block_size;
+} __packed;
+
+struct session_log_conn {
+    uint8_t type;       /* conn_evt_type_t */
+    uint8_t reason;     /* HCI reason, disconnect only */
+    uint8_t addr_type;
+    uint8_t addr[6];
+} __packed;
+
+/* The passkey is deliberately not logged */
+struct session_log_sec {
+    uint8_t type;       /* sec_evt_type_t */
+    uint8_t level;
+    uint8_t err;
+    uint8_t bonded;
+} __packed;
+
+struct session_log_gatt_write {
+    uint16_t handle;
+    uint16_t offset;
+    uint16_t len;
+} __packed;
+
+struct session_log_stats {
+    session_log_backend_t backend;
+    uint32_t records;
+    uint32_t dropped;       /* every block waiting for storage */
+    uint32_t blocks;        /* written */
+    uint32_t bytes;         /* written, incl. padding on SD */
+    uint32_t write_errors;
+    uint32_t write_us;      /* total time in the storage backend */
+    uint32_t lat_max_us;    /* block sealed to block stored */
+    uint32_t lat_avg_us;
+};
+
+/* --------------------------------------------------------------------------
+ * Public Functions
+ * -------------------------------------------------------------------------- */
+/**
+ * @brief Log a GATT write, call from the attribute's write callback
+ *
+ * @param [in] handle Attribute handle
+ * @param [in] offset Write offset
+ * @param [in] len    Bytes written
+ */
+void session_log_gatt_write(uint16_t handle, uint16_t offset, uint16_t len);
+
+/**
+ * @brief Write out every logged record without waiting for a full block
+ */
+void session_log_flush(void);
+
+/**
+ * @brief Get the logger statistics
+ *
+ * @param [out] out Statistics
+ */
+void session_log_stats_get(struct session_log_stats *out);
+
+#endif /* SESSION_LOG_H */
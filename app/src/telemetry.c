@@ -0,0 +1,378 @@
+/**
+ * @file telemetry.c
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/sys_heap.h>
+#include <zephyr/sys/util.h>
+
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/bluetooth/uuid.h>
+#include <zephyr/bluetooth/gatt.h>
+
+#ifdef CONFIG_LVGL
+#include <lvgl_mem.h>
+#endif
+
+#ifdef CONFIG_SHELL
+#include <zephyr/shell/shell.h>
+#endif
+
+#ifdef CONFIG_APP_SETTINGS
+#include <zephyr/settings/settings.h>
+#include "app_settings.h"
+#endif
+
+#include "telemetry.h"
+
+LOG_MODULE_REGISTER(telemetry, CONFIG_APP_LOG_LEVEL);
+
+/* --------------------------------------------------------------------------
+ * Constants
+ * -------------------------------------------------------------------------- */
+#define TLM_PERIOD_MIN_MS 100
+#define TLM_PERIOD_MAX_MS 60000
+#define TLM_FRAG_MAX      15   /* fragment count must fit 4 bits */
+
+#define BT_UUID_TELEMETRY_SERVICE_VAL \
+    BT_UUID_128_ENCODE(0x12345678, 0x1234, 0x5678, 0x1234, 0x56789abcdf10)
+#define BT_UUID_TELEMETRY_DATA_CHAR_VAL \
+    BT_UUID_128_ENCODE(0x12345678, 0x1234, 0x5678, 0x1234, 0x56789abcdf11)
+#define BT_UUID_TELEMETRY_PERIOD_CHAR_VAL \
+    BT_UUID_128_ENCODE(0x12345678, 0x1234, 0x5678, 0x1234, 0x56789abcdf12)
+
+#define BT_UUID_TELEMETRY_SERVICE     BT_UUID_DECLARE_128(BT_UUID_TELEMETRY_SERVICE_VAL)
+#define BT_UUID_TELEMETRY_DATA_CHAR   BT_UUID_DECLARE_128(BT_UUID_TELEMETRY_DATA_CHAR_VAL)
+#define BT_UUID_TELEMETRY_PERIOD_CHAR BT_UUID_DECLARE_128(BT_UUID_TELEMETRY_PERIOD_CHAR_VAL)
+
+/* --------------------------------------------------------------------------
+ * Global States
+ * -------------------------------------------------------------------------- */
+/* Matched as name prefixes, the BT RX thread name varies between versions */
+static const char *const tlm_thread_names[TLM_THREAD_COUNT] = {
+    [TLM_THREAD_MAIN]      = "main",
+    [TLM_THREAD_BT_RX]     = "BT RX",
+    [TLM_THREAD_SYSWORKQ]  = "sysworkq",
+    [TLM_THREAD_LED_BLINK] = "led_blink",
+};
+
+#if K_HEAP_MEM_POOL_SIZE > 0
+/* kernel/mempool.c defines it under the same condition, there's no accessor */
+extern struct k_heap _system_heap;
+#endif
+
+/* Sampling state, shared by the notify work and the shell */
+static K_MUTEX_DEFINE(tlm_lock);
+static k_tid_t  tlm_threads[TLM_THREAD_COUNT];
+static uint64_t tlm_thread_prev[TLM_THREAD_COUNT];
+static uint64_t tlm_all_prev;
+static uint64_t tlm_busy_prev;
+static uint16_t tlm_seq;
+
+static struct k_work_delayable tlm_work;
+static atomic_t                tlm_enabled;
+static uint16_t                tlm_period_ms = CONFIG_APP_TELEMETRY_PERIOD_MS;
+
+/* --------------------------------------------------------------------------
+ * Private Functions
+ * -------------------------------------------------------------------------- */
+static void tlm_thread_find(const struct k_thread *thread, void *user_data)
+{
+    const char *name = k_thread_name_get((k_tid_t)thread);
+
+    if (!name) {
+        return;
+    }
+    for (size_t i = 0; i < TLM_THREAD_COUNT; i++) {
+        if (!tlm_threads[i] &&
+            !strncmp(name, tlm_thread_names[i], strlen(tlm_thread_names[i]))) {
+            tlm_threads[i] = (k_tid_t)thread;
+        }
+    }
+}
+
+static uint16_t tlm_permille(uint64_t part, uint64_t whole)
+{
+    return whole ? (uint16_t)MIN((part * 1000U) / whole, 1000U) : 0U;
+}
+
+static void tlm_batch_to_le(struct tlm_batch *b)
+{
+    b->seq            = sys_cpu_to_le16(b->seq);
+    b->uptime_ms      = sys_cpu_to_le32(b->uptime_ms);
+    b->cpu_permille   = sys_cpu_to_le16(b->cpu_permille);
+    b->sys_heap_used  = sys_cpu_to_le32(b->sys_heap_used);
+    b->sys_heap_max   = sys_cpu_to_le32(b->sys_heap_max);
+    b->lvgl_heap_used = sys_cpu_to_le32(b->lvgl_heap_used);
+    b->lvgl_heap_max  = sys_cpu_to_le32(b->lvgl_heap_max);
+    for (size_t i = 0; i < TLM_THREAD_COUNT; i++) {
+        b->threads[i].stack_size   = sys_cpu_to_le16(b->threads[i].stack_size);
+        b->threads[i].stack_used   = sys_cpu_to_le16(b->threads[i].stack_used);
+        b->threads[i].cpu_permille = sys_cpu_to_le16(b->threads[i].cpu_permille);
+    }
+}
+
+/* advance: start the next CPU share window and sequence number here */
+static void tlm_collect(struct tlm_batch *out, bool advance)
+{
+    k_thread_runtime_stats_t all;
+    struct sys_memory_stats heap;
+
+    k_mutex_lock(&tlm_lock, K_FOREVER);
+
+    /* Threads that were not up yet at the previous sample */
+    k_thread_foreach_unlocked(tlm_thread_find, NULL);
+    k_thread_runtime_stats_all_get(&all);
+
+    /* execution_cycles counts idle too, total_cycles only busy time */
+    uint64_t period = all.execution_cycles - tlm_all_prev;
+
+    *out = (struct tlm_batch){
+        .seq          = tlm_seq,
+        .uptime_ms    = k_uptime_get_32(),
+        .cpu_permille = tlm_permille(all.total_cycles - tlm_busy_prev, period),
+    };
+    if (advance) {
+        tlm_seq++;
+        tlm_all_prev  = all.execution_cycles;
+        tlm_busy_prev = all.total_cycles;
+    }
+
+    for (size_t i = 0; i < TLM_THREAD_COUNT; i++) {
+        struct tlm_thread_sample *t = &out->threads[i];
+        k_tid_t tid = tlm_threads[i];
+        k_thread_runtime_stats_t st;
+        size_t unused;
+
+        t->id = i;
+        if (!tid) {
+            continue;
+        }
+
+        k_thread_runtime_stats_get(tid, &st);
+        t->cpu_permille = tlm_permille(st.execution_cycles - tlm_thread_prev[i], period);
+        if (advance) {
+            tlm_thread_prev[i] = st.execution_cycles;
+        }
+
+        t->stack_size = MIN(tid->stack_info.size, UINT16_MAX);
+        if (0 == k_thread_stack_space_get(tid, &unused)) {
+            t->stack_used = t->stack_size - MIN(unused, t->stack_size);
+        }
+    }
+
+#if K_HEAP_MEM_POOL_SIZE > 0
+    if (0 == sys_heap_runtime_stats_get(&_system_heap.heap, &heap)) {
+        out->sys_heap_used = heap.allocated_bytes;
+        out->sys_heap_max  = heap.max_allocated_bytes;
+    }
+#endif
+#ifdef CONFIG_LVGL
+    lvgl_heap_stats(&heap);
+    out->lvgl_heap_used = heap.allocated_bytes;
+    out->lvgl_heap_max  = heap.max_allocated_bytes;
+#endif
+
+    k_mutex_unlock(&tlm_lock);
+}
+
+/* --------------------------------------------------------------------------
+ * Public Functions
+ * -------------------------------------------------------------------------- */
+void telemetry_sample(struct tlm_batch *out)
+{
+    tlm_collect(out, true);
+}
+
+void telemetry_peek(struct tlm_batch *out)
+{
+    tlm_collect(out, false);
+}
+
+/* --------------------------------------------------------------------------
+ * Telemetry GATT Service
+ * -------------------------------------------------------------------------- */
+static void tlm_ccc_changed(const struct bt_gatt_attr *attr, uint16_t value)
+{
+    bool enable = (value & BT_GATT_CCC_NOTIFY);
+
+    if (enable == atomic_set(&tlm_enabled, enable)) {
+        return;
+    }
+
+    if (enable) {
+        struct tlm_batch prime;
+
+        /* Start the CPU share window now, not at the last subscription */
+        telemetry_sample(&prime);
+        k_work_reschedule(&tlm_work, K_MSEC(tlm_period_ms));
+    } else {
+        k_work_cancel_delayable(&tlm_work);
+    }
+    LOG_DBG("Telemetry %s", enable ? "on" : "off");
+}
+
+static ssize_t read_tlm_period(struct bt_conn *conn, const struct bt_gatt_attr *attr,
+                               void *buf, uint16_t len, uint16_t offset)
+{
+    uint16_t value = sys_cpu_to_le16(tlm_period_ms);
+
+    return bt_gatt_attr_read(conn, attr, buf, len, offset, &value, sizeof(value));
+}
+
+static ssize_t write_tlm_period(struct bt_conn *conn, const struct bt_gatt_attr *attr,
+                                const void *buf, uint16_t len, uint16_t offset,
+                                uint8_t flags)
+{
+    if (offset) {
+        return BT_GATT_ERR(BT_ATT_ERR_INVALID_OFFSET);
+    }
+    if (len != sizeof(uint16_t)) {
+        return BT_GATT_ERR(BT_ATT_ERR_INVALID_ATTRIBUTE_LEN);
+    }
+
+    uint16_t period = sys_get_le16(buf);
+
+    if (period < TLM_PERIOD_MIN_MS || period > TLM_PERIOD_MAX_MS) {
+        return BT_GATT_ERR(BT_ATT_ERR_VALUE_NOT_ALLOWED);
+    }
+
+    tlm_period_ms = period;
+    if (atomic_get(&tlm_enabled)) {
+        k_work_reschedule(&tlm_work, K_MSEC(tlm_period_ms));
+    }
+#ifdef CONFIG_APP_SETTINGS
+    /* Batched, so a peer tuning the period doesn't write flash per value */
+    app_settings_save("app/tlm/period", &tlm_period_ms, sizeof(tlm_period_ms));
+#endif
+    return len;
+}
+
+#ifdef CONFIG_APP_SETTINGS
+static int tlm_settings_set(const char *key, size_t len, settings_read_cb read_cb,
+                            void *cb_arg)
+{
+    uint16_t period;
+
+    if (!settings_name_steq(key, "period", NULL)) {
+        return -ENOENT;
+    }
+    if (len != sizeof(period) || read_cb(cb_arg, &period, sizeof(period)) != sizeof(period)) {
+        return -EINVAL;
+    }
+    if (period >= TLM_PERIOD_MIN_MS && period <= TLM_PERIOD_MAX_MS) {
+        tlm_period_ms = period;
+    }
+    return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(tlm, "app/tlm", NULL, tlm_settings_set, NULL, NULL);
+#endif /* CONFIG_APP_SETTINGS */
+
+BT_GATT_SERVICE_DEFINE(telemetry_svc,
+    BT_GATT_PRIMARY_SERVICE(BT_UUID_TELEMETRY_SERVICE),
+    BT_GATT_CHARACTERISTIC(BT_UUID_TELEMETRY_DATA_CHAR,
+                           BT_GATT_CHRC_NOTIFY,
+                           BT_GATT_PERM_READ_AUTHEN,
+                           NULL, NULL, NULL),
+    BT_GATT_CCC(tlm_ccc_changed, BT_GATT_PERM_READ_AUTHEN | BT_GATT_PERM_WRITE_AUTHEN),
+    BT_GATT_CHARACTERISTIC(BT_UUID_TELEMETRY_PERIOD_CHAR,
+                           BT_GATT_CHRC_READ | BT_GATT_CHRC_WRITE,
+                           BT_GATT_PERM_READ_AUTHEN | BT_GATT_PERM_WRITE_AUTHEN,
+                           read_tlm_period, write_tlm_period, NULL),
+);
+
+/* Send one batch to conn, split into MTU-sized fragments */
+static void tlm_send(struct bt_conn *conn, void *user_data)
+{
+    const struct bt_gatt_attr *attr = &telemetry_svc.attrs[2];
+    const uint8_t *batch = user_data;
+    uint8_t pdu[sizeof(struct tlm_frag_hdr) + sizeof(struct tlm_batch)];
+
+    if (!bt_gatt_is_subscribed(conn, attr, BT_GATT_CCC_NOTIFY)) {
+        return;
+    }
+
+    /* ATT notification header is 3 bytes */
+    size_t chunk = bt_gatt_get_mtu(conn) - 3U - sizeof(struct tlm_frag_hdr);
+    size_t count = DIV_ROUND_UP(sizeof(struct tlm_batch), chunk);
+
+    if (count > TLM_FRAG_MAX) {
+        return;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        size_t len = MIN(chunk, sizeof(struct tlm_batch) - i * chunk);
+        struct tlm_frag_hdr *hdr = (struct tlm_frag_hdr *)pdu;
+
+        hdr->seq  = batch[0]; /* low byte of the LE sequence number */
+        hdr->frag = (uint8_t)((i << 4) | count);
+        memcpy(pdu + sizeof(*hdr), batch + i * chunk, len);
+
+        int err = bt_gatt_notify(conn, attr, pdu, sizeof(*hdr) + len);
+
+        if (err) {
+            /* Out of buffers: drop the rest, the next batch supersedes it */
+            LOG_DBG("Batch dropped at fragment %u (err %d)", (unsigned int)i, err);
+            return;
+        }
+    }
+}
+
+static void tlm_work_handler(struct k_work *work)
+{
+    struct tlm_batch batch;
+
+    telemetry_sample(&batch);
+    tlm_batch_to_le(&batch);
+    bt_conn_foreach(BT_CONN_TYPE_LE, tlm_send, &batch);
+
+    if (atomic_get(&tlm_enabled)) {
+        k_work_reschedule(&tlm_work, K_MSEC(tlm_period_ms));
+    }
+}
+
+static int telemetry_init(void)
+{
+    k_work_init_delayable(&tlm_work, tlm_work_handler);
+    return 0;
+}
+
+SYS_INIT(telemetry_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+/* --------------------------------------------------------------------------
+ * Shell Commands
+ * -------------------------------------------------------------------------- */
+#ifdef CONFIG_SHELL
+static int cmd_tlm_show(const struct shell *sh, size_t argc, char **argv)
+{
+    struct tlm_batch b;
+
+    /* Doesn't cut short the window of the next notified batch */
+    telemetry_peek(&b);
+
+    shell_print(sh, "cpu %u.%u%%  sys heap %u/%u B  lvgl heap %u/%u B",
+                b.cpu_permille / 10U, b.cpu_permille % 10U,
+                b.sys_heap_used, b.sys_heap_max, b.lvgl_heap_used, b.lvgl_heap_max);
+    shell_print(sh, "%-10s %6s %6s %6s", "thread", "stack", "used", "cpu[%]");
+    for (size_t i = 0; i < TLM_THREAD_COUNT; i++) {
+        shell_print(sh, "%-10s %6u %6u %4u.%u", tlm_thread_names[i],
+                    b.threads[i].stack_size, b.threads[i].stack_used,
+                    b.threads[i].cpu_permille / 10U, b.threads[i].cpu_permille % 10U);
+    }
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(tlm_cmds,
+    SHELL_CMD(show, NULL, "CPU (since the last batch), stack and heap usage", cmd_tlm_show),
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(tlm, &tlm_cmds, "Runtime telemetry", NULL);
+#endif /* CONFIG_SHELL */
@@ -0,0 +1,78 @@
+/**
+ * @file telemetry.h
+ * @brief Runtime health telemetry over an authenticated GATT service
+ *
+ * While a peer is subscribed, CPU load, per-thread CPU share and stack
+ * high-water marks, and system/LVGL heap watermarks are sampled every
+ * CONFIG_APP_TELEMETRY_PERIOD_MS (writable over GATT) and sent as one batch,
+ * split into MTU-sized notifications. Nothing is sampled while no peer is
+ * subscribed.
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdint.h>
+
+#include <zephyr/toolchain.h>
+
+/* --------------------------------------------------------------------------
+ * Types
+ * -------------------------------------------------------------------------- */
+typedef enum {
+    TLM_THREAD_MAIN = 0,
+    TLM_THREAD_BT_RX,
+    TLM_THREAD_SYSWORKQ,
+    TLM_THREAD_LED_BLINK,
+    TLM_THREAD_COUNT,
+} tlm_thread_t;
+
+/* Wire format, little endian. A batch is sent as notifications of
+ * struct tlm_frag_hdr followed by the next chunk of struct tlm_batch. */
+struct tlm_frag_hdr {
+    uint8_t seq;       /* low byte of tlm_batch.seq */
+    uint8_t frag;      /* index << 4 | count */
+} __packed;
+
+struct tlm_thread_sample {
+    uint8_t  id;           /* tlm_thread_t */
+    uint16_t stack_size;   /* bytes */
+    uint16_t stack_used;   /* high-water mark, bytes */
+    uint16_t cpu_permille; /* share of the last period */
+} __packed;
+
+struct tlm_batch {
+    uint16_t seq;
+    uint32_t uptime_ms;
+    uint16_t cpu_permille;     /* non-idle share of the last period */
+    uint32_t sys_heap_used;
+    uint32_t sys_heap_max;
+    uint32_t lvgl_heap_used;
+    uint32_t lvgl_heap_max;
+    struct tlm_thread_sample threads[TLM_THREAD_COUNT];
+} __packed;
+
+/* --------------------------------------------------------------------------
+ * Public Functions
+ * -------------------------------------------------------------------------- */
+/**
+ * @brief Take one sample now
+ *
+ * CPU shares cover the time since the previous sample.
+ *
+ * @param [out] out Destination, in CPU byte order
+ */
+void telemetry_sample(struct tlm_batch *out);
+
+/**
+ * @brief Read the current values without taking a sample
+ *
+ * Same as telemetry_sample() but the CPU share window and the sequence
+ * number are left alone, so the next notified batch still covers its whole
+ * period.
+ *
+ * @param [out] out Destination, in CPU byte order
+ */
+void telemetry_peek(struct tlm_batch *out);
+
+#endif /* TELEMETRY_H */
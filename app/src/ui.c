@@ -0,0 +1,661 @@
+/**
+ * @file ui.c
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/display.h>
+#include <zephyr/pm/device_runtime.h>
+#include <zephyr/smf.h>
+#include <zephyr/timing/timing.h>
+#include <zephyr/zbus/zbus.h>
+#include <lvgl.h>
+
+#ifdef CONFIG_SHELL
+#include <zephyr/shell/shell.h>
+#endif
+
+#ifdef CONFIG_EIE_FT6206
+#include "FT6206.h"
+#endif
+
+#include "events.h"
+#include "power.h"
+#include "ui.h"
+
+#ifdef CONFIG_APP_SCANNER
+#include "scan_table.h"
+#include "scanner.h"
+#endif
+
+LOG_MODULE_DECLARE(app, CONFIG_APP_LOG_LEVEL);
+
+/* --------------------------------------------------------------------------
+ * Constants
+ * -------------------------------------------------------------------------- */
+#define UI_TRACE_LEN CONFIG_APP_UI_TRACE_LEN
+
+/* Transition table cells hold target + 1 so that 0 means "not handled here" */
+#define TO(state) ((uint8_t)((state) + 1))
+
+/* --------------------------------------------------------------------------
+ * Types
+ * -------------------------------------------------------------------------- */
+/* Leaf states share their index with ui_state_t, parents follow */
+typedef enum {
+    UI_NODE_IDLE = UI_STATE_COUNT, /* no link: advertising */
+    UI_NODE_LINK,                  /* connected, any security level */
+    UI_NODE_COUNT,
+} ui_node_t;
+
+/* Everything drawn for one leaf state */
+struct ui_view {
+    uint32_t         col_bg;
+    uint32_t         col_title;
+    uint32_t         col_sub;
+    const lv_font_t *title_font;
+    const char      *title_text; /* NULL: show the passkey */
+    const char      *sub_text;
+};
+
+struct ui_sm {
+    struct smf_ctx ctx;          /* must be first */
+    ui_event_t     event;        /* event being dispatched */
+    uint32_t       passkey;
+    bool           handled;
+};
+
+/* --------------------------------------------------------------------------
+ * Private Function Prototypes
+ * -------------------------------------------------------------------------- */
+static void ui_leaf_entry(void *obj);
+static enum smf_state_result ui_leaf_run(void *obj);
+static enum smf_state_result ui_idle_run(void *obj);
+static enum smf_state_result ui_link_run(void *obj);
+
+/* --------------------------------------------------------------------------
+ * Global States
+ * -------------------------------------------------------------------------- */
+static const struct ui_view ui_views[UI_STATE_COUNT] = {
+    [UI_STATE_ADVERTISING] = {
+        .col_bg = 0x003080, .col_title = 0xFFFFFF, .col_sub = 0xADD8E6,
+        .title_font = &lv_font_montserrat_48,
+        .title_text = "BLE Secure Demo",
+        .sub_text   = "Open nRF Connect\non your phone\nand connect.",
+    },
+    [UI_STATE_CONNECTED] = {
+        .col_bg = 0x806000, .col_title = 0xFFFF00, .col_sub = 0xFFFFFF,
+        .title_font = &lv_font_montserrat_28,
+        .title_text = "Connected!",
+        .sub_text   = "Waiting for\npairing request...",
+    },
+    [UI_STATE_PASSKEY] = {
+        .col_bg = 0x1A1A2E, .col_title = 0xFFFFFF, .col_sub = 0xFFD700,
+        .title_font = &lv_font_montserrat_48, /* big digits */
+        .title_text = NULL,
+        .sub_text   = "Match this passkey\non your phone\n(nRF Connect)",
+    },
+    [UI_STATE_PAIRED] = {
+        .col_bg = 0x004000, .col_title = 0x00FF80, .col_sub = 0xFFFFFF,
+        .title_font = &lv_font_montserrat_48,
+        .title_text = "Paired!",
+        .sub_text   = "Secure link active.",
+    },
+    [UI_STATE_PAIR_FAILED] = {
+        .col_bg = 0x600000, .col_title = 0xFF4040, .col_sub = 0xFFFFFF,
+        .title_font = &lv_font_montserrat_28,
+        .title_text = "Pairing FAILED",
+        .sub_text   = "Check phone and\nretry connection.",
+    },
+};
+
+/* Rows are looked up leaf first, then parent; an empty cell propagates */
+static const uint8_t ui_transitions[UI_NODE_COUNT][UI_EV_COUNT] = {
+    [UI_STATE_ADVERTISING] = {
+        [UI_EV_CONNECTED] = TO(UI_STATE_CONNECTED),
+    },
+    [UI_STATE_CONNECTED] = {
+        [UI_EV_PASSKEY]   = TO(UI_STATE_PASSKEY),
+        [UI_EV_PAIRED]    = TO(UI_STATE_PAIRED),   /* bonded peer, no passkey */
+        [UI_EV_FAILED]    = TO(UI_STATE_PAIR_FAILED),
+    },
+    [UI_STATE_PASSKEY] = {
+        [UI_EV_PASSKEY]   = TO(UI_STATE_PASSKEY),  /* new passkey, re-enter */
+        [UI_EV_PAIRED]    = TO(UI_STATE_PAIRED),
+        [UI_EV_FAILED]    = TO(UI_STATE_PAIR_FAILED),
+    },
+    [UI_STATE_PAIRED] = {
+        [UI_EV_FAILED]    = TO(UI_STATE_PAIR_FAILED), /* re-encryption failed */
+    },
+    [UI_STATE_PAIR_FAILED] = {
+        [UI_EV_PASSKEY]   = TO(UI_STATE_PASSKEY),  /* peer retries */
+        [UI_EV_PAIRED]    = TO(UI_STATE_PAIRED),
+    },
+    [UI_NODE_IDLE] = {0},
+    [UI_NODE_LINK] = {
+        [UI_EV_DISCONNECTED] = TO(UI_STATE_ADVERTISING),
+    },
+};
+
+static const char *const ui_state_names[UI_STATE_COUNT] = {
+    [UI_STATE_ADVERTISING] = "advertising",
+    [UI_STATE_CONNECTED]   = "connected",
+    [UI_STATE_PASSKEY]     = "passkey",
+    [UI_STATE_PAIRED]      = "paired",
+    [UI_STATE_PAIR_FAILED] = "pair_failed",
+};
+
+static const char *const ui_event_names[UI_EV_COUNT] = {
+    [UI_EV_CONNECTED]    = "connected",
+    [UI_EV_DISCONNECTED] = "disconnected",
+    [UI_EV_PASSKEY]      = "passkey",
+    [UI_EV_PAIRED]       = "paired",
+    [UI_EV_FAILED]       = "failed",
+};
+
+static const struct smf_state ui_states[UI_NODE_COUNT] = {
+    [UI_NODE_IDLE] = SMF_CREATE_STATE(NULL, ui_idle_run, NULL, NULL, NULL),
+    [UI_NODE_LINK] = SMF_CREATE_STATE(NULL, ui_link_run, NULL, NULL, NULL),
+    [UI_STATE_ADVERTISING] = SMF_CREATE_STATE(ui_leaf_entry, ui_leaf_run, NULL,
+                                              &ui_states[UI_NODE_IDLE], NULL),
+    [UI_STATE_CONNECTED]   = SMF_CREATE_STATE(ui_leaf_entry, ui_leaf_run, NULL,
+                                              &ui_states[UI_NODE_LINK], NULL),
+    [UI_STATE_PASSKEY]     = SMF_CREATE_STATE(ui_leaf_entry, ui_leaf_run, NULL,
+                                              &ui_states[UI_NODE_LINK], NULL),
+    [UI_STATE_PAIRED]      = SMF_CREATE_STATE(ui_leaf_entry, ui_leaf_run, NULL,
+                                              &ui_states[UI_NODE_LINK], NULL),
+    [UI_STATE_PAIR_FAILED] = SMF_CREATE_STATE(ui_leaf_entry, ui_leaf_run, NULL,
+                                              &ui_states[UI_NODE_LINK], NULL),
+};
+
+static struct ui_sm ui_sm;
+static char         ui_passkey[8];
+static bool         ui_needs_update = true;
+static bool         ui_blanked;
+
+static const struct device *const ui_display = DEVICE_DT_GET(DT_CHOSEN(zephyr_display));
+
+#ifdef CONFIG_EIE_FT6206
+static const struct device *const ui_touch = DEVICE_DT_GET_ANY(eie_ft6206);
+#endif
+
+/* LVGL objects — created once in ui_init(), updated by the entry actions */
+static lv_obj_t *bg_rect     = NULL;
+static lv_obj_t *label_title = NULL;
+static lv_obj_t *label_sub   = NULL;
+
+/* What is currently on screen, entry actions only touch what differs */
+static struct ui_view ui_applied;
+
+/* Trace and stats are read from the shell thread */
+static struct k_spinlock     ui_trace_lock;
+static struct ui_trace_entry ui_trace[UI_TRACE_LEN];
+static uint8_t               ui_trace_head;
+static uint8_t               ui_trace_count;
+static uint32_t              ui_transitions_taken;
+static uint32_t              ui_transitions_rejected;
+static uint64_t              ui_cost_sum_ns;
+static uint32_t              ui_cost_max_ns;
+
+/* --------------------------------------------------------------------------
+ * Private Functions
+ * -------------------------------------------------------------------------- */
+static ui_state_t ui_current(void)
+{
+    return (ui_state_t)(ui_sm.ctx.current - ui_states);
+}
+
+static void ui_apply_view(const struct ui_view *v)
+{
+    if (!bg_rect) {
+        return;
+    }
+
+    if (ui_applied.col_bg != v->col_bg) {
+        lv_obj_set_style_bg_color(bg_rect, lv_color_hex(v->col_bg), LV_PART_MAIN);
+    }
+    if (ui_applied.title_font != v->title_font) {
+        lv_obj_set_style_text_font(label_title, v->title_font, LV_PART_MAIN);
+    }
+    if (ui_applied.col_title != v->col_title) {
+        lv_obj_set_style_text_color(label_title, lv_color_hex(v->col_title), LV_PART_MAIN);
+    }
+    /* Texts are static (view table, ui_passkey), labels don't copy them to
+     * the LVGL pool. The passkey changes between sessions, so it's always
+     * rewritten. */
+    if (!v->title_text || ui_applied.title_text != v->title_text) {
+        lv_label_set_text_static(label_title, v->title_text ? v->title_text : ui_passkey);
+    }
+    if (ui_applied.col_sub != v->col_sub) {
+        lv_obj_set_style_text_color(label_sub, lv_color_hex(v->col_sub), LV_PART_MAIN);
+    }
+    if (ui_applied.sub_text != v->sub_text) {
+        lv_label_set_text_static(label_sub, v->sub_text);
+    }
+
+    ui_applied = *v;
+    ui_needs_update = true;
+}
+
+static void ui_leaf_entry(void *obj)
+{
+    struct ui_sm *sm = obj;
+    ui_state_t state = ui_current();
+
+    if (state == UI_STATE_PASSKEY) {
+        snprintk(ui_passkey, sizeof(ui_passkey), "%06u", sm->passkey);
+    }
+    ui_apply_view(&ui_views[state]);
+}
+
+static enum smf_state_result ui_table_run(struct ui_sm *sm, unsigned int node)
+{
+    uint8_t cell = ui_transitions[node][sm->event];
+
+    if (!cell) {
+        return SMF_EVENT_PROPAGATE;
+    }
+
+    sm->handled = true;
+    smf_set_state(SMF_CTX(sm), &ui_states[cell - 1]);
+    return SMF_EVENT_HANDLED;
+}
+
+static enum smf_state_result ui_leaf_run(void *obj)
+{
+    return ui_table_run(obj, ui_current());
+}
+
+static enum smf_state_result ui_idle_run(void *obj)
+{
+    return ui_table_run(obj, UI_NODE_IDLE);
+}
+
+static enum smf_state_result ui_link_run(void *obj)
+{
+    return ui_table_run(obj, UI_NODE_LINK);
+}
+
+static void ui_trace_add(ui_state_t from, uint8_t to, ui_event_t ev, uint32_t cost_ns)
+{
+    k_spinlock_key_t key = k_spin_lock(&ui_trace_lock);
+
+    if (to == UI_TRACE_REJECTED) {
+        ui_transitions_rejected++;
+    } else {
+        ui_transitions_taken++;
+        ui_cost_sum_ns += cost_ns;
+        ui_cost_max_ns  = MAX(ui_cost_max_ns, cost_ns);
+    }
+
+    ui_trace[ui_trace_head] = (struct ui_trace_entry){
+        .uptime_ms = k_uptime_get_32(),
+        .cost_ns   = cost_ns,
+        .from      = from,
+        .to        = to,
+        .event     = ev,
+    };
+    ui_trace_head = (ui_trace_head + 1) % UI_TRACE_LEN;
+    if (ui_trace_count < UI_TRACE_LEN) {
+        ui_trace_count++;
+    }
+    k_spin_unlock(&ui_trace_lock, key);
+}
+
+#ifdef CONFIG_APP_SCANNER
+/* While advertising, the hint under the title is replaced by the strongest
+ * nearby devices (* = advertises the secure demo service) */
+static void ui_scan_refresh(void)
+{
+    static uint32_t refreshed_ms;
+    static char text[CONFIG_APP_SCANNER_TOP_N * 24];
+    struct scan_entry top[CONFIG_APP_SCANNER_TOP_N];
+    uint32_t now = k_uptime_get_32();
+
+    if (!bg_rect || ui_current() != UI_STATE_ADVERTISING || !scanner_is_running() ||
+        (now - refreshed_ms) < CONFIG_APP_SCANNER_UI_REFRESH_MS) {
+        return;
+    }
+    refreshed_ms = now;
+
+    size_t n = scan_table_top(top, ARRAY_SIZE(top));
+    int len = 0;
+
+    if (!n) {
+        return;
+    }
+    for (size_t i = 0; i < n; i++) {
+        const uint8_t *a = top[i].addr.a.val;
+
+        len += snprintk(text + len, sizeof(text) - len, "%s%02X:%02X:%02X %4d dBm%s",
+                        i ? "\n" : "", a[2], a[1], a[0], top[i].rssi,
+                        top[i].match ? " *" : "");
+    }
+    lv_label_set_text_static(label_sub, text);
+    /* Restore the view's own text on the next state entry */
+    ui_applied.sub_text = NULL;
+    ui_needs_update = true;
+}
+#endif
+
+/* --------------------------------------------------------------------------
+ * Public Functions
+ * -------------------------------------------------------------------------- */
+void ui_render(void)
+{
+#ifdef CONFIG_APP_SCANNER
+    ui_scan_refresh();
+#endif
+    if (!ui_needs_update || !bg_rect || ui_blanked) {
+        return;
+    }
+    ui_needs_update = false;
+    lv_refr_now(NULL);
+}
+
+int ui_dispatch(ui_event_t ev, uint32_t passkey)
+{
+    ui_state_t from = ui_current();
+    timing_t start = timing_counter_get();
+
+    ui_sm.event   = ev;
+    ui_sm.passkey = passkey;
+    ui_sm.handled = false;
+    smf_run_state(SMF_CTX(&ui_sm));
+
+    timing_t end = timing_counter_get();
+    uint32_t cost_ns = (uint32_t)timing_cycles_to_ns(timing_cycles_get(&start, &end));
+
+    if (!ui_sm.handled) {
+        ui_trace_add(from, UI_TRACE_REJECTED, ev, cost_ns);
+        LOG_WRN("[UI] Rejected event %s in state %s", ui_event_names[ev],
+                ui_state_names[from]);
+        return -EPERM;
+    }
+
+    ui_trace_add(from, ui_current(), ev, cost_ns);
+
+    struct ui_evt evt = {.state = ui_current()};
+
+    evt_publish(&ui_chan, &evt);
+    return 0;
+}
+
+ui_state_t ui_state_get(void)
+{
+    return ui_current();
+}
+
+bool ui_is_blanked(void)
+{
+    return ui_blanked;
+}
+
+size_t ui_trace_get(struct ui_trace_entry *out, size_t max)
+{
+    k_spinlock_key_t key = k_spin_lock(&ui_trace_lock);
+    size_t first = (ui_trace_head + UI_TRACE_LEN - ui_trace_count) % UI_TRACE_LEN;
+    size_t n = MIN(max, ui_trace_count);
+
+    for (size_t i = 0; i < n; i++) {
+        out[i] = ui_trace[(first + i) % UI_TRACE_LEN];
+    }
+    k_spin_unlock(&ui_trace_lock, key);
+    return n;
+}
+
+void ui_transition_stats_get(struct ui_transition_stats *out)
+{
+    k_spinlock_key_t key = k_spin_lock(&ui_trace_lock);
+
+    out->transitions = ui_transitions_taken;
+    out->rejected    = ui_transitions_rejected;
+    out->cost_avg_ns = ui_transitions_taken ?
+                       (uint32_t)(ui_cost_sum_ns / ui_transitions_taken) : 0U;
+    out->cost_max_ns = ui_cost_max_ns;
+    k_spin_unlock(&ui_trace_lock, key);
+}
+
+/* --------------------------------------------------------------------------
+ * This function initializes LVGL screen objects
+ * -------------------------------------------------------------------------- */
+int ui_init(void)
+{
+    int err = 0;
+
+    timing_init();
+    timing_start();
+
+    if (!device_is_ready(ui_display)) {
+        LOG_ERR("[UI] Display device not ready");
+        err = -ENODEV;
+        goto start_sm;
+    }
+
+    /* Held while the screen is on, released by the power manager */
+    pm_device_runtime_enable(ui_display);
+    pm_device_runtime_get(ui_display);
+    display_blanking_off(ui_display);
+
+    lv_obj_t *scr = lv_scr_act();
+
+    /* Full-screen coloured background */
+    bg_rect = lv_obj_create(scr);
+    lv_obj_set_size(bg_rect, LV_HOR_RES, LV_VER_RES);
+    lv_obj_set_pos(bg_rect, 0, 0);
+    lv_obj_set_style_border_width(bg_rect, 0, LV_PART_MAIN);
+    lv_obj_set_style_radius(bg_rect, 0, LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(bg_rect, LV_OPA_COVER, LV_PART_MAIN);
+
+    /* Title label*/
+    label_title = lv_label_create(bg_rect);
+    lv_label_set_long_mode(label_title, LV_LABEL_LONG_WRAP);
+    lv_obj_set_width(label_title, LV_HOR_RES - 20);
+    lv_obj_align(label_title, LV_ALIGN_TOP_MID, 0, 20);
+    lv_obj_set_style_text_align(label_title, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN);
+
+    /* Sub-title label*/
+    label_sub = lv_label_create(bg_rect);
+    lv_label_set_long_mode(label_sub, LV_LABEL_LONG_WRAP);
+    lv_obj_set_width(label_sub, LV_HOR_RES - 20);
+    lv_obj_align(label_sub, LV_ALIGN_BOTTOM_MID, 0, -20);
+    lv_obj_set_style_text_align(label_sub, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN);
+    lv_obj_set_style_text_font(label_sub, &lv_font_montserrat_16, LV_PART_MAIN);
+
+    LOG_INF("[UI] Display initialised (%d x %d)", LV_HOR_RES, LV_VER_RES);
+
+#ifdef CONFIG_EIE_FT6206
+    if (!ft6206_lvgl_register(ui_touch)) {
+        LOG_WRN("[UI] Touch controller not ready");
+    }
+#endif
+
+start_sm:
+    /* Entry of the initial state paints the first screen in full */
+    smf_set_initial(SMF_CTX(&ui_sm), &ui_states[UI_STATE_ADVERTISING]);
+    return err;
+}
+
+/* --------------------------------------------------------------------------
+ * Event Handling
+ * -------------------------------------------------------------------------- */
+ZBUS_MSG_SUBSCRIBER_DEFINE(ui_sub);
+ZBUS_CHAN_ADD_OBS(conn_chan, ui_sub, 0);
+ZBUS_CHAN_ADD_OBS(sec_chan, ui_sub, 0);
+ZBUS_CHAN_ADD_OBS(pwr_chan, ui_sub, 0);
+#ifdef CONFIG_APP_DFU
+ZBUS_CHAN_ADD_OBS(dfu_chan, ui_sub, 0);
+#endif
+
+static void ui_handle_conn(const struct conn_evt *evt)
+{
+    switch (evt->type) {
+    case CONN_EVT_CONNECTED:
+        ui_dispatch(UI_EV_CONNECTED, 0);
+        break;
+    case CONN_EVT_DISCONNECTED:
+        ui_dispatch(UI_EV_DISCONNECTED, 0);
+        break;
+    }
+}
+
+static void ui_handle_sec(const struct sec_evt *evt)
+{
+    switch (evt->type) {
+    case SEC_EVT_PASSKEY:
+        ui_dispatch(UI_EV_PASSKEY, evt->passkey);
+        break;
+    case SEC_EVT_PAIRED:
+        ui_dispatch(UI_EV_PAIRED, 0);
+        break;
+    case SEC_EVT_FAILED:
+        ui_dispatch(UI_EV_FAILED, 0);
+        break;
+    case SEC_EVT_LEVEL_CHANGED:
+    default:
+        break;
+    }
+}
+
+/* LVGL objects keep tracking the state while blanked; waking only
+ * invalidates the screen so the next ui_render() repaints it */
+static void ui_handle_pwr(const struct pwr_evt *evt)
+{
+    bool blank = (evt->state != PWR_STATE_ACTIVE);
+
+    if (blank == ui_blanked || !bg_rect) {
+        return;
+    }
+
+    if (blank) {
+        display_blanking_on(ui_display);
+        pm_device_runtime_put(ui_display);
+    } else {
+        pm_device_runtime_get(ui_display);
+        display_blanking_off(ui_display);
+        lv_obj_invalidate(lv_screen_active());
+        ui_needs_update = true;
+    }
+    ui_blanked = blank;
+}
+
+#ifdef CONFIG_APP_DFU
+/* Upload progress replaces the hint under the title; like the scan list it
+ * stays until the next state entry restores the view's own text */
+static void ui_handle_dfu(const struct dfu_evt *evt)
+{
+    static char text[48];
+
+    if (!bg_rect) {
+        return;
+    }
+    switch (evt->type) {
+    case DFU_EVT_STARTED:
+    case DFU_EVT_PROGRESS:
+        snprintk(text, sizeof(text), "Updating firmware\n%u%%  (%u / %u KiB)",
+                 evt->size ? (uint32_t)(((uint64_t)evt->offset * 100U) / evt->size) : 0U,
+                 evt->offset / 1024U, evt->size / 1024U);
+        break;
+    case DFU_EVT_DONE:
+        snprintk(text, sizeof(text), "Update received.\nRestart to apply.");
+        break;
+    case DFU_EVT_FAILED:
+    default:
+        snprintk(text, sizeof(text), "Update failed.");
+        break;
+    }
+    lv_label_set_text_static(label_sub, text);
+    ui_applied.sub_text = NULL;
+    ui_needs_update = true;
+}
+#endif
+
+void ui_process_events(k_timeout_t timeout)
+{
+    const struct zbus_channel *chan;
+    union {
+        struct conn_evt conn;
+        struct sec_evt  sec;
+        struct pwr_evt  pwr;
+        struct dfu_evt  dfu;
+    } msg;
+
+    /* One queued copy per publish, oldest first */
+    while (0 == evt_wait(&ui_sub, &chan, &msg, timeout)) {
+        if (chan == &conn_chan) {
+            ui_handle_conn(&msg.conn);
+        } else if (chan == &sec_chan) {
+            ui_handle_sec(&msg.sec);
+        } else if (chan == &pwr_chan) {
+            ui_handle_pwr(&msg.pwr);
+#ifdef CONFIG_APP_DFU
+        } else if (chan == &dfu_chan) {
+            ui_handle_dfu(&msg.dfu);
+#endif
+        }
+        timeout = K_NO_WAIT;
+    }
+}
+
+/* --------------------------------------------------------------------------
+ * Shell Commands
+ * -------------------------------------------------------------------------- */
+#ifdef CONFIG_SHELL
+static int cmd_ui_trace(const struct shell *sh, size_t argc, char **argv)
+{
+    struct ui_trace_entry trace[UI_TRACE_LEN];
+    size_t n = ui_trace_get(trace, ARRAY_SIZE(trace));
+
+    for (size_t i = 0; i < n; i++) {
+        shell_print(sh, "%8u ms  %-12s --%-12s--> %-12s %6u ns", trace[i].uptime_ms,
+                    ui_state_names[trace[i].from], ui_event_names[trace[i].event],
+                    trace[i].to == UI_TRACE_REJECTED ? "REJECTED" : ui_state_names[trace[i].to],
+                    trace[i].cost_ns);
+    }
+    return 0;
+}
+
+static int cmd_ui_stats(const struct shell *sh, size_t argc, char **argv)
+{
+    struct ui_transition_stats st;
+
+    ui_transition_stats_get(&st);
+    shell_print(sh, "state %s%s, %u transitions, %u rejected, cost avg %u ns max %u ns",
+                ui_state_names[ui_current()], ui_blanked ? " (blanked)" : "",
+                st.transitions, st.rejected,
+                st.cost_avg_ns, st.cost_max_ns);
+    return 0;
+}
+
+#ifdef CONFIG_EIE_FT6206
+static int cmd_ui_touch(const struct shell *sh, size_t argc, char **argv)
+{
+    ft6206_stats st;
+
+    ft6206_stats_get(ui_touch, &st);
+    shell_print(sh, "%u irqs, %u reads (%u failed), %u samples, %u coalesced, %u dropped",
+                st.irqs, st.reads, st.read_errors, st.samples, st.coalesced, st.dropped);
+    shell_print(sh, "irq->read max %u us, irq->lvgl min %u avg %u max %u us",
+                st.read_lat_max_us, st.lat_min_us, st.lat_avg_us, st.lat_max_us);
+    if (argc > 1 && !strcmp(argv[1], "reset")) {
+        ft6206_stats_reset(ui_touch);
+    }
+    return 0;
+}
+#endif
+
+SHELL_STATIC_SUBCMD_SET_CREATE(ui_cmds,
+    SHELL_CMD(trace, NULL, "UI transition trace", cmd_ui_trace),
+    SHELL_CMD(stats, NULL, "UI transition count and cost", cmd_ui_stats),
+#ifdef CONFIG_EIE_FT6206
+    SHELL_CMD_ARG(touch, NULL, "Touch input counters and latency [reset]", cmd_ui_touch, 1, 1),
+#endif
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(ui, &ui_cmds, "UI state machine", NULL);
+#endif /* CONFIG_SHELL */
@@ -0,0 +1,130 @@
+/**
+ * @file ui.h
+ * @brief LCD status screen driven by connection and security events
+ *
+ * The UI is a hierarchical SMF: leaf states (ui_state_t) live under an
+ * "idle" parent (no link) or a "link" parent (connected). Events are looked
+ * up in a const transition table; events with no entry for the current
+ * state or any of its parents are rejected and recorded in the trace.
+ */
+
+#ifndef UI_H
+#define UI_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <zephyr/kernel.h>
+
+/* --------------------------------------------------------------------------
+ * Types
+ * -------------------------------------------------------------------------- */
+typedef enum {
+    UI_STATE_ADVERTISING,
+    UI_STATE_CONNECTED,
+    UI_STATE_PASSKEY,
+    UI_STATE_PAIRED,
+    UI_STATE_PAIR_FAILED,
+    UI_STATE_COUNT,
+} ui_state_t;
+
+typedef enum {
+    UI_EV_CONNECTED = 0,
+    UI_EV_DISCONNECTED,
+    UI_EV_PASSKEY,
+    UI_EV_PAIRED,
+    UI_EV_FAILED,
+    UI_EV_COUNT,
+} ui_event_t;
+
+#define UI_TRACE_REJECTED 0xFF
+
+/* One transition (or rejected event) in the trace ring */
+struct ui_trace_entry {
+    uint32_t uptime_ms;
+    uint32_t cost_ns;  /* dispatch incl. exit/entry actions */
+    uint8_t  from;     /* ui_state_t */
+    uint8_t  to;       /* ui_state_t, UI_TRACE_REJECTED if rejected */
+    uint8_t  event;    /* ui_event_t */
+};
+
+struct ui_transition_stats {
+    uint32_t transitions;
+    uint32_t rejected;
+    uint32_t cost_avg_ns;
+    uint32_t cost_max_ns;
+};
+
+/* --------------------------------------------------------------------------
+ * Public Functions
+ * -------------------------------------------------------------------------- */
+/**
+ * @brief Create the LVGL screen objects
+ *
+ * @return Error code, < 0 on failures (-ENODEV if no display is attached)
+ */
+int ui_init(void);
+
+/**
+ * @brief Repaint the screen if the state changed since the last call
+ */
+void ui_render(void);
+
+/**
+ * @brief Wait for connection/security events and apply them to the UI state
+ *
+ * Blocks for at most timeout waiting for the first event, then drains any
+ * further pending events without blocking. Must be called from the thread
+ * that runs ui_render().
+ *
+ * @param [in] timeout Maximum time to wait for the first event
+ */
+void ui_process_events(k_timeout_t timeout);
+
+/**
+ * @brief Feed one event to the state machine
+ *
+ * Must be called from the thread that runs ui_render().
+ *
+ * @param [in] ev      The event
+ * @param [in] passkey Passkey to show, UI_EV_PASSKEY only
+ *
+ * @return 0 if a transition was taken, -EPERM if the event was rejected
+ */
+int ui_dispatch(ui_event_t ev, uint32_t passkey);
+
+/**
+ * @brief Get the current leaf state
+ *
+ * @return The current state
+ */
+ui_state_t ui_state_get(void);
+
+/**
+ * @brief Check whether the power manager blanked the display
+ *
+ * While blanked ui_render() does nothing and LVGL need not be serviced.
+ *
+ * @return true if blanked
+ */
+bool ui_is_blanked(void);
+
+/**
+ * @brief Copy the transition trace, oldest entry first
+ *
+ * @param [out] out Destination array
+ * @param [in]  max Number of entries out can hold
+ *
+ * @return Number of entries copied
+ */
+size_t ui_trace_get(struct ui_trace_entry *out, size_t max);
+
+/**
+ * @brief Get transition count, rejections and cost
+ *
+ * @param [out] out Destination
+ */
+void ui_transition_stats_get(struct ui_transition_stats *out);
+
+#endif /* UI_H */
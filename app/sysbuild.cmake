@@ -0,0 +1,11 @@
+# SPDX-License-Identifier: Apache-2.0
+#
+# On BabbleSim the benchmark central is built next to the app, so
+# pytest/test_bsim.py can run both against the simulated phy.
+if("${BOARD}" STREQUAL "nrf52_bsim")
+  ExternalZephyrProject_Add(
+    APPLICATION bsim_central
+    SOURCE_DIR ${APP_DIR}/../bench/bsim_central
+    BOARD ${BOARD}
+  )
+endif()
@@ -0,0 +1,67 @@
+#!/usr/bin/env bash
+# Pairing / GATT throughput benchmark on BabbleSim.
+#
+# Runs the app (peripheral) against bench/bsim_central on a simulated 2.4 GHz
+# phy, writes the BENCH metrics to bench_bsim.json and fails if any metric is
+# outside thresholds.conf.
+#
+# Twister runs it for app.bsim (app/pytest/test_bsim.py), passing the
+# images it built through APP_EXE / CENTRAL_EXE:
+#   west twister -p nrf52_bsim -T app -s app.bsim
+#
+# Run by hand, point APP_EXE / CENTRAL_EXE at the two zephyr.exe images of
+# a sysbuild build of app for nrf52_bsim (app/zephyr, bsim_central/zephyr).
+# The defaults are bs_<platform>_<bsim_exe_name> copies in
+# ${BSIM_OUT_PATH}/bin.
+#
+# Usage: run.sh [output.json]
+
+set -eu
+
+: "${BSIM_OUT_PATH:?BSIM_OUT_PATH must point to the BabbleSim output directory}"
+
+here="$(cd "$(dirname "$0")" && pwd)"
+out="${1:-bench_bsim.json}"
+sim_id="eie_bench_$$"
+sim_length_us=60e6
+log="$(mktemp)"
+app_exe="${APP_EXE:-./bs_nrf52_bsim_app_bsim}"
+central_exe="${CENTRAL_EXE:-./bs_nrf52_bsim_bench_bsim_central}"
+
+cd "${BSIM_OUT_PATH}/bin"
+
+./bs_2G4_phy_v1 -s="${sim_id}" -D=2 -sim_length="${sim_length_us}" >/dev/null &
+"${app_exe}" -s="${sim_id}" -d=0 -RealEncryption=1 >/dev/null &
+"${central_exe}" -s="${sim_id}" -d=1 -RealEncryption=1 >"${log}" 2>&1 || true
+wait
+
+line="$(grep -m1 '^BENCH conn_us=' "${log}" || true)"
+if [ -z "${line}" ]; then
+    cat "${log}"
+    echo "No BENCH result" >&2
+    exit 1
+fi
+
+# "BENCH a=1 b=2" -> {"a": 1, "b": 2}
+echo "${line#BENCH }" | awk '{
+    printf "{";
+    for (i = 1; i <= NF; i++) { split($i, kv, "="); printf "%s\"%s\": %s", (i > 1 ? ", " : ""), kv[1], kv[2]; }
+    print "}";
+}' >"${out}"
+cat "${out}"
+
+fail=0
+while read -r metric kind limit; do
+    case "${metric}" in ''|\#*) continue ;; esac
+    value="$(echo "${line}" | tr ' ' '\n' | sed -n "s/^${metric}=//p")"
+    if [ -z "${value}" ]; then
+        echo "FAIL ${metric}: missing" >&2; fail=1; continue
+    fi
+    if { [ "${kind}" = max ] && [ "${value}" -gt "${limit}" ]; } ||
+       { [ "${kind}" = min ] && [ "${value}" -lt "${limit}" ]; }; then
+        echo "FAIL ${metric}=${value} (${kind} ${limit})" >&2; fail=1
+    fi
+done <"${here}/thresholds.conf"
+
+rm -f "${log}"
+exit "${fail}"
@@ -0,0 +1,754 @@
+/**
+ * @file main.c
+ * @brief Simulated central driving the pairing / GATT throughput benchmark
+ *
+ * Scans for the app, connects, pairs at L4 (numeric comparison, confirmed
+ * automatically), then reads and writes the secure demo characteristics
+ * CONFIG_BENCH_GATT_ITERATIONS times, reads the whole service with one request
+ * per value and with ATT Read Multiple Variable, streams
+ * CONFIG_BENCH_COC_BYTES over the bulk L2CAP channel on the same link and
+ * uploads a CONFIG_BENCH_DFU_BYTES image over MCUmgr SMP. The result is a
+ * single BENCH line that run.sh turns into tracked metrics.
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/net_buf.h>
+
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/hci.h>
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/bluetooth/uuid.h>
+#include <zephyr/bluetooth/gatt.h>
+#include <zephyr/bluetooth/l2cap.h>
+#include <zephyr/mgmt/mcumgr/transport/smp_bt.h>
+
+#include <zcbor_decode.h>
+#include <zcbor_encode.h>
+
+#include "secure_svc.h"
+
+LOG_MODULE_REGISTER(central, CONFIG_BENCH_LOG_LEVEL);
+
+/* --------------------------------------------------------------------------
+ * Constants
+ * -------------------------------------------------------------------------- */
+#define STEP_TIMEOUT K_MSEC(CONFIG_BENCH_STEP_TIMEOUT_MS)
+
+/* SMP frames: 8-byte header (op, flags, length, group, seq, id), CBOR body */
+#define SMP_HDR_LEN           8
+#define SMP_OP_READ           0
+#define SMP_OP_WRITE          2
+#define SMP_GRP_OS            0
+#define SMP_GRP_IMG           1
+#define SMP_ID_OS_PARAMS      6
+#define SMP_ID_IMG_UPLOAD     1
+/* Room for the app's CONFIG_MCUMGR_TRANSPORT_NETBUF_SIZE */
+#define SMP_FRAME_MAX         2560
+/* Map, keys and integers of an upload request around the data */
+#define SMP_UPLOAD_OVERHEAD   32
+
+/* MCUboot image header, the app checks its magic on the first chunk */
+#define DFU_IMAGE_MAGIC       0x96f3b83dU
+#define DFU_IMAGE_HDR_LEN     32
+
+/* Service UUID advertised by the app (see ad[] in app/src/main.c) */
+static const uint8_t peer_uuid[] = {BT_UUID_SECURE_DEMO_SERVICE_VAL};
+
+/* --------------------------------------------------------------------------
+ * Global States
+ * -------------------------------------------------------------------------- */
+static struct bt_conn *peer_conn;
+
+static K_SEM_DEFINE(step_sem, 0, 1);
+static int step_err;
+
+static uint16_t read_handle;
+static uint16_t write_handle;
+static uint16_t gen_handle;
+static uint16_t smp_handle;
+static uint32_t read_bytes;
+static uint32_t read_pdus;
+static atomic_t notifies;
+
+/* Sized for the app's CONFIG_APP_L2CAP_BULK_MTU default */
+#define COC_SDU_MAX 512
+
+NET_BUF_POOL_FIXED_DEFINE(coc_tx_pool, CONFIG_BENCH_COC_SDUS, BT_L2CAP_SDU_BUF_SIZE(COC_SDU_MAX),
+                          0, NULL);
+
+static struct bt_l2cap_le_chan coc_chan;
+static K_SEM_DEFINE(coc_sent_sem, 0, K_SEM_MAX_LIMIT);
+
+/* SMP response being reassembled from notifications */
+static uint8_t  smp_rsp[128];
+static uint16_t smp_rsp_len;
+static uint8_t  smp_seq;
+
+/* --------------------------------------------------------------------------
+ * Private Functions
+ * -------------------------------------------------------------------------- */
+static void step_done(int err)
+{
+    step_err = err;
+    k_sem_give(&step_sem);
+}
+
+static int step_wait(const char *what)
+{
+    if (k_sem_take(&step_sem, STEP_TIMEOUT)) {
+        LOG_ERR("[BENCH] Timeout waiting for %s", what);
+        return -ETIMEDOUT;
+    }
+    if (step_err) {
+        LOG_ERR("[BENCH] %s failed (err %d)", what, step_err);
+    }
+    return step_err;
+}
+
+static uint32_t elapsed_us(int64_t start_ticks)
+{
+    return (uint32_t)k_ticks_to_us_floor64(k_uptime_ticks() - start_ticks);
+}
+
+static uint32_t rate_bps(uint32_t bytes, uint32_t us)
+{
+    return us ? (uint32_t)(((uint64_t)bytes * USEC_PER_SEC) / us) : 0U;
+}
+
+/* --------------------------------------------------------------------------
+ * Scanning
+ * -------------------------------------------------------------------------- */
+static bool ad_has_uuid(struct bt_data *data, void *user_data)
+{
+    bool *match = user_data;
+
+    if (data->type == BT_DATA_UUID128_ALL) {
+        *match = (data->data_len == sizeof(peer_uuid)) &&
+                 !memcmp(data->data, peer_uuid, sizeof(peer_uuid));
+        return false;
+    }
+    return true;
+}
+
+static void device_found(const bt_addr_le_t *addr, int8_t rssi, uint8_t type,
+                         struct net_buf_simple *ad)
+{
+    bool match = false;
+
+    if (peer_conn || (type != BT_GAP_ADV_TYPE_ADV_IND)) {
+        return;
+    }
+
+    bt_data_parse(ad, ad_has_uuid, &match);
+    if (!match || bt_le_scan_stop()) {
+        return;
+    }
+
+    int err = bt_conn_le_create(addr, BT_CONN_LE_CREATE_CONN,
+                                BT_LE_CONN_PARAM_DEFAULT, &peer_conn);
+
+    if (err) {
+        step_done(err);
+    }
+}
+
+/* --------------------------------------------------------------------------
+ * Connection / Auth Callbacks
+ * -------------------------------------------------------------------------- */
+static void connected(struct bt_conn *conn, uint8_t err)
+{
+    if (conn != peer_conn) {
+        return;
+    }
+    if (err) {
+        bt_conn_unref(peer_conn);
+        peer_conn = NULL;
+    }
+    step_done(err);
+}
+
+static void disconnected(struct bt_conn *conn, uint8_t reason)
+{
+    LOG_INF("[CONN] Disconnected (reason 0x%02x)", reason);
+}
+
+BT_CONN_CB_DEFINE(conn_callbacks) = {
+    .connected    = connected,
+    .disconnected = disconnected,
+};
+
+static void passkey_confirm(struct bt_conn *conn, unsigned int passkey)
+{
+    LOG_INF("[AUTH] Confirming %06u", passkey);
+    bt_conn_auth_passkey_confirm(conn);
+}
+
+static void passkey_display(struct bt_conn *conn, unsigned int passkey)
+{
+    LOG_INF("[AUTH] Passkey %06u", passkey);
+}
+
+static void auth_cancel(struct bt_conn *conn)
+{
+    step_done(-ECANCELED);
+}
+
+static void pairing_complete(struct bt_conn *conn, bool bonded)
+{
+    step_done(0);
+}
+
+static void pairing_failed(struct bt_conn *conn, enum bt_security_err reason)
+{
+    step_done(-EACCES);
+}
+
+static struct bt_conn_auth_cb auth_cb = {
+    .passkey_display = passkey_display,
+    .passkey_confirm = passkey_confirm,
+    .cancel          = auth_cancel,
+};
+
+static struct bt_conn_auth_info_cb auth_info_cb = {
+    .pairing_complete = pairing_complete,
+    .pairing_failed   = pairing_failed,
+};
+
+/* --------------------------------------------------------------------------
+ * GATT Client
+ * -------------------------------------------------------------------------- */
+static void mtu_exchanged(struct bt_conn *conn, uint8_t err,
+                          struct bt_gatt_exchange_params *params)
+{
+    step_done(err);
+}
+
+static uint8_t chrc_discovered(struct bt_conn *conn, const struct bt_gatt_attr *attr,
+                               struct bt_gatt_discover_params *params)
+{
+    if (!attr) {
+        step_done((read_handle && write_handle && gen_handle && smp_handle) ? 0 : -ENOENT);
+        return BT_GATT_ITER_STOP;
+    }
+
+    const struct bt_gatt_chrc *chrc = attr->user_data;
+
+    if (!bt_uuid_cmp(chrc->uuid, BT_UUID_SECURE_READ_CHAR)) {
+        read_handle = chrc->value_handle;
+    } else if (!bt_uuid_cmp(chrc->uuid, BT_UUID_SECURE_WRITE_CHAR)) {
+        write_handle = chrc->value_handle;
+    } else if (!bt_uuid_cmp(chrc->uuid, BT_UUID_SECURE_GEN_CHAR)) {
+        gen_handle = chrc->value_handle;
+    } else if (!bt_uuid_cmp(chrc->uuid, SMP_BT_CHR_UUID)) {
+        smp_handle = chrc->value_handle;
+    }
+    return BT_GATT_ITER_CONTINUE;
+}
+
+static uint8_t read_done(struct bt_conn *conn, uint8_t err,
+                         struct bt_gatt_read_params *params,
+                         const void *data, uint16_t length)
+{
+    if (err || !data) {
+        step_done(err);
+        return BT_GATT_ITER_STOP;
+    }
+    /* One response PDU per call, except for a read multiple: one per value */
+    read_bytes += length;
+    read_pdus++;
+    return BT_GATT_ITER_CONTINUE;
+}
+
+static void write_done(struct bt_conn *conn, uint8_t err,
+                       struct bt_gatt_write_params *params)
+{
+    step_done(err);
+}
+
+static uint8_t notified(struct bt_conn *conn, struct bt_gatt_subscribe_params *params,
+                        const void *data, uint16_t length)
+{
+    if (data) {
+        atomic_inc(&notifies);
+    }
+    return BT_GATT_ITER_CONTINUE;
+}
+
+static void subscribed(struct bt_conn *conn, uint8_t err,
+                       struct bt_gatt_subscribe_params *params)
+{
+    step_done(err);
+}
+
+/* Every readable value of the secure service, CONFIG_BENCH_SVC_READS times:
+ * one read each (blobs included), or one Read Multiple Variable request.
+ * us and rtts are per whole-service read. */
+static int svc_read(bool multiple, uint32_t *us, uint32_t *rtts)
+{
+    static uint16_t handles[3];
+    static struct bt_gatt_read_params params = {.func = read_done};
+    uint32_t requests = 0;
+    int err;
+
+    handles[0] = read_handle;
+    handles[1] = write_handle;
+    handles[2] = gen_handle;
+    read_pdus = 0;
+
+    int64_t t0 = k_uptime_ticks();
+
+    for (int i = 0; i < CONFIG_BENCH_SVC_READS; i++) {
+        if (multiple) {
+            params.handle_count      = ARRAY_SIZE(handles);
+            params.multiple.handles  = handles;
+            params.multiple.variable = true;
+            err = bt_gatt_read(peer_conn, &params);
+            if (err || (err = step_wait("read multiple"))) {
+                return err;
+            }
+            requests++;
+            continue;
+        }
+        for (size_t h = 0; h < ARRAY_SIZE(handles); h++) {
+            params.handle_count  = 1;
+            params.single.handle = handles[h];
+            params.single.offset = 0;
+            err = bt_gatt_read(peer_conn, &params);
+            if (err || (err = step_wait("read"))) {
+                return err;
+            }
+        }
+    }
+    if (!multiple) {
+        requests = read_pdus; /* a read or read blob per response */
+    }
+    *us   = elapsed_us(t0) / CONFIG_BENCH_SVC_READS;
+    *rtts = requests / CONFIG_BENCH_SVC_READS;
+    return 0;
+}
+
+/* --------------------------------------------------------------------------
+ * L2CAP Channel
+ * -------------------------------------------------------------------------- */
+static void coc_connected(struct bt_l2cap_chan *chan)
+{
+    step_done(0);
+}
+
+static void coc_disconnected(struct bt_l2cap_chan *chan)
+{
+    /* Only waited on when the connection request is refused */
+    step_done(-ECONNREFUSED);
+}
+
+static int coc_recv(struct bt_l2cap_chan *chan, struct net_buf *buf)
+{
+    return 0;
+}
+
+static void coc_sent(struct bt_l2cap_chan *chan)
+{
+    k_sem_give(&coc_sent_sem);
+}
+
+static const struct bt_l2cap_chan_ops coc_ops = {
+    .connected    = coc_connected,
+    .disconnected = coc_disconnected,
+    .recv         = coc_recv,
+    .sent         = coc_sent,
+};
+
+/* Stream CONFIG_BENCH_COC_BYTES in channel-MTU SDUs, the app's credits
+ * pace the transfer. us is the time until every SDU was sent. */
+static int coc_stream(uint32_t *us)
+{
+    uint32_t queued = 0;
+    uint32_t sdus = 0;
+    int err;
+
+    coc_chan.chan.ops = &coc_ops;
+    err = bt_l2cap_chan_connect(peer_conn, &coc_chan.chan, SECURE_BULK_PSM);
+    if (err || (err = step_wait("L2CAP connect"))) {
+        return err;
+    }
+
+    uint16_t sdu_len = MIN(coc_chan.tx.mtu, COC_SDU_MAX);
+    int64_t t0 = k_uptime_ticks();
+
+    while (queued < CONFIG_BENCH_COC_BYTES) {
+        /* Buffers come back once sent: blocks while the app holds credits */
+        struct net_buf *buf = net_buf_alloc(&coc_tx_pool, STEP_TIMEOUT);
+        uint16_t n = MIN(sdu_len, CONFIG_BENCH_COC_BYTES - queued);
+
+        if (!buf) {
+            LOG_ERR("[BENCH] Timeout waiting for L2CAP credits");
+            return -ETIMEDOUT;
+        }
+        net_buf_reserve(buf, BT_L2CAP_SDU_CHAN_SEND_RESERVE);
+        memset(net_buf_add(buf, n), 'c', n);
+
+        err = bt_l2cap_chan_send(&coc_chan.chan, buf);
+        if (err) {
+            net_buf_unref(buf);
+            LOG_ERR("[BENCH] L2CAP send failed (err %d)", err);
+            return err;
+        }
+        queued += n;
+        sdus++;
+    }
+
+    while (sdus--) {
+        if (k_sem_take(&coc_sent_sem, STEP_TIMEOUT)) {
+            LOG_ERR("[BENCH] Timeout waiting for L2CAP send");
+            return -ETIMEDOUT;
+        }
+    }
+    *us = elapsed_us(t0);
+    return 0;
+}
+
+/* --------------------------------------------------------------------------
+ * Firmware Update (MCUmgr SMP)
+ * -------------------------------------------------------------------------- */
+static uint8_t smp_notified(struct bt_conn *conn, struct bt_gatt_subscribe_params *params,
+                            const void *data, uint16_t length)
+{
+    if (!data) {
+        return BT_GATT_ITER_STOP;
+    }
+
+    uint16_t n = MIN(length, sizeof(smp_rsp) - smp_rsp_len);
+
+    memcpy(&smp_rsp[smp_rsp_len], data, n);
+    smp_rsp_len += n;
+    if (smp_rsp_len >= SMP_HDR_LEN &&
+        smp_rsp_len >= SMP_HDR_LEN + sys_get_be16(&smp_rsp[2])) {
+        step_done(0);
+    }
+    return BT_GATT_ITER_CONTINUE;
+}
+
+/* Unsigned value of key in the top-level map of an SMP response body */
+static bool smp_rsp_uint(const uint8_t *body, size_t len, const char *key, uint32_t *out)
+{
+    zcbor_state_t zs[3];
+    struct zcbor_string k;
+    size_t key_len = strlen(key);
+
+    zcbor_new_decode_state(zs, ARRAY_SIZE(zs), body, len, 1, NULL, 0);
+    if (!zcbor_map_start_decode(zs)) {
+        return false;
+    }
+    while (zcbor_tstr_decode(zs, &k)) {
+        if (k.len == key_len && !memcmp(k.value, key, key_len)) {
+            return zcbor_uint32_decode(zs, out);
+        }
+        if (!zcbor_any_skip(zs, NULL)) {
+            break;
+        }
+    }
+    return false;
+}
+
+/* Send the request whose body_len bytes of CBOR follow the header in frame,
+ * as ATT-payload-sized writes without response, and wait for the whole
+ * response. rc in the response fails the request. */
+static int smp_request(uint8_t op, uint16_t group, uint8_t id, uint8_t *frame,
+                       size_t body_len, const uint8_t **body, size_t *rsp_len)
+{
+    uint16_t att_len = bt_gatt_get_mtu(peer_conn) - 3U;
+    size_t len = SMP_HDR_LEN + body_len;
+    uint32_t rc = 0;
+    int err;
+
+    frame[0] = op;
+    frame[1] = 0;
+    sys_put_be16(body_len, &frame[2]);
+    sys_put_be16(group, &frame[4]);
+    frame[6] = smp_seq++;
+    frame[7] = id;
+
+    smp_rsp_len = 0;
+    for (size_t sent = 0; sent < len; sent += att_len) {
+        err = bt_gatt_write_without_response(peer_conn, smp_handle, &frame[sent],
+                                             MIN(att_len, len - sent), false);
+        if (err) {
+            LOG_ERR("[BENCH] SMP write failed (err %d)", err);
+            return err;
+        }
+    }
+    err = step_wait("SMP response");
+    if (err) {
+        return err;
+    }
+
+    *body    = &smp_rsp[SMP_HDR_LEN];
+    *rsp_len = smp_rsp_len - SMP_HDR_LEN;
+    if (smp_rsp_uint(*body, *rsp_len, "rc", &rc) && rc) {
+        LOG_ERR("[BENCH] SMP group %u id %u failed (rc %u)", group, id, rc);
+        return -EIO;
+    }
+    return 0;
+}
+
+/* Bytes [off, off + n) of the image: an MCUboot header without TLVs, then
+ * filler. The app stores it but it never boots. */
+static void dfu_image_fill(uint8_t *buf, uint32_t off, uint32_t n)
+{
+    uint8_t hdr[DFU_IMAGE_HDR_LEN] = {0};
+
+    sys_put_le32(DFU_IMAGE_MAGIC, &hdr[0]);
+    sys_put_le16(DFU_IMAGE_HDR_LEN, &hdr[8]);
+    sys_put_le32(CONFIG_BENCH_DFU_BYTES - DFU_IMAGE_HDR_LEN, &hdr[12]);
+    for (uint32_t i = 0; i < n; i++) {
+        buf[i] = (off + i < sizeof(hdr)) ? hdr[off + i] : (uint8_t)(off + i);
+    }
+}
+
+/* Upload CONFIG_BENCH_DFU_BYTES to the app's secondary slot, each request as
+ * large as the app's SMP buffers (buf_size) allow. us is first request to
+ * last response. */
+static int dfu_upload(uint32_t *us, uint32_t *chunks, uint32_t *buf_size)
+{
+    static uint8_t frame[SMP_FRAME_MAX];
+    static uint8_t chunk[SMP_FRAME_MAX];
+    static struct bt_gatt_subscribe_params smp_sub = {
+        .notify    = smp_notified,
+        .subscribe = subscribed,
+        .value     = BT_GATT_CCC_NOTIFY,
+    };
+    zcbor_state_t zs[2];
+    const uint8_t *body;
+    size_t body_len;
+    int err;
+
+    /* Responses come back as notifications, the CCC follows the value */
+    smp_sub.value_handle = smp_handle;
+    smp_sub.ccc_handle   = smp_handle + 1;
+    err = bt_gatt_subscribe(peer_conn, &smp_sub);
+    if (err || (err = step_wait("SMP subscribe"))) {
+        return err;
+    }
+
+    /* MCUmgr parameters: empty request map */
+    zcbor_new_encode_state(zs, ARRAY_SIZE(zs), &frame[SMP_HDR_LEN],
+                           sizeof(frame) - SMP_HDR_LEN, 0);
+    if (!zcbor_map_start_encode(zs, 0) || !zcbor_map_end_encode(zs, 0)) {
+        return -ENOMEM;
+    }
+    err = smp_request(SMP_OP_READ, SMP_GRP_OS, SMP_ID_OS_PARAMS, frame,
+                      zs->payload - &frame[SMP_HDR_LEN], &body, &body_len);
+    if (err) {
+        return err;
+    }
+    if (!smp_rsp_uint(body, body_len, "buf_size", buf_size) ||
+        *buf_size <= SMP_HDR_LEN + SMP_UPLOAD_OVERHEAD) {
+        LOG_ERR("[BENCH] No usable SMP buffer size");
+        return -EBADMSG;
+    }
+
+    uint32_t data_max = MIN(*buf_size, sizeof(frame)) - SMP_HDR_LEN - SMP_UPLOAD_OVERHEAD;
+    uint32_t off = 0;
+    int64_t t0 = k_uptime_ticks();
+
+    *chunks = 0;
+    while (off < CONFIG_BENCH_DFU_BYTES) {
+        uint32_t n = MIN(data_max, CONFIG_BENCH_DFU_BYTES - off);
+        uint32_t next;
+
+        dfu_image_fill(chunk, off, n);
+        zcbor_new_encode_state(zs, ARRAY_SIZE(zs), &frame[SMP_HDR_LEN],
+                               sizeof(frame) - SMP_HDR_LEN, 0);
+        /* The first chunk also carries the image length */
+        bool ok = zcbor_map_start_encode(zs, 3) &&
+                  zcbor_tstr_put_lit(zs, "off") && zcbor_uint32_put(zs, off) &&
+                  zcbor_tstr_put_lit(zs, "data") && zcbor_bstr_encode_ptr(zs, chunk, n) &&
+                  (off || (zcbor_tstr_put_lit(zs, "len") &&
+                           zcbor_uint32_put(zs, CONFIG_BENCH_DFU_BYTES))) &&
+                  zcbor_map_end_encode(zs, 3);
+
+        if (!ok) {
+            return -ENOMEM;
+        }
+        err = smp_request(SMP_OP_WRITE, SMP_GRP_IMG, SMP_ID_IMG_UPLOAD, frame,
+                          zs->payload - &frame[SMP_HDR_LEN], &body, &body_len);
+        if (err) {
+            return err;
+        }
+        /* The app answers with the offset it expects next */
+        if (!smp_rsp_uint(body, body_len, "off", &next) || next <= off) {
+            LOG_ERR("[BENCH] Upload stalled at %u", off);
+            return -EIO;
+        }
+        off = next;
+        (*chunks)++;
+    }
+    *us = elapsed_us(t0);
+    return 0;
+}
+
+/* --------------------------------------------------------------------------
+ * Benchmark
+ * -------------------------------------------------------------------------- */
+static int run_bench(void)
+{
+    static struct bt_gatt_exchange_params mtu_params = {.func = mtu_exchanged};
+    static struct bt_gatt_discover_params disc_params = {
+        .func         = chrc_discovered,
+        .start_handle = BT_ATT_FIRST_ATTRIBUTE_HANDLE,
+        .end_handle   = BT_ATT_LAST_ATTRIBUTE_HANDLE,
+        .type         = BT_GATT_DISCOVER_CHARACTERISTIC,
+    };
+    static struct bt_gatt_read_params read_params = {
+        .func         = read_done,
+        .handle_count = 1,
+    };
+    static struct bt_gatt_write_params write_params = {.func = write_done};
+    static struct bt_gatt_subscribe_params sub_params = {
+        .notify    = notified,
+        .subscribe = subscribed,
+        .value     = BT_GATT_CCC_NOTIFY,
+    };
+    static uint8_t payload[SECURE_WRITE_MAX_LEN];
+    int err;
+
+    /* Connection: scan start -> connected */
+    int64_t t0 = k_uptime_ticks();
+
+    err = bt_le_scan_start(BT_LE_SCAN_PASSIVE, device_found);
+    if (err || (err = step_wait("connection"))) {
+        return err;
+    }
+    uint32_t conn_us = elapsed_us(t0);
+
+    /* Pairing: security request -> pairing complete */
+    t0 = k_uptime_ticks();
+    err = bt_conn_set_security(peer_conn, BT_SECURITY_L4);
+    if (err || (err = step_wait("pairing"))) {
+        return err;
+    }
+    uint32_t pair_us = elapsed_us(t0);
+
+    err = bt_gatt_discover(peer_conn, &disc_params);
+    if (err || (err = step_wait("discovery"))) {
+        return err;
+    }
+
+    /* The CCC follows the value (app/src/main.c) */
+    sub_params.value_handle = write_handle;
+    sub_params.ccc_handle   = write_handle + 1;
+    err = bt_gatt_subscribe(peer_conn, &sub_params);
+    if (err || (err = step_wait("subscribe"))) {
+        return err;
+    }
+
+    /* Long write while the ATT MTU is still the default: the whole message
+     * goes out as several prepared fragments and one Execute Write, and
+     * must be notified once, complete. The notification is queued ahead of
+     * the Execute Write response. */
+    memset(payload, 'l', sizeof(payload));
+    write_params.handle = write_handle;
+    write_params.data   = payload;
+    write_params.length = sizeof(payload);
+    err = bt_gatt_write(peer_conn, &write_params);
+    if (err || (err = step_wait("long write"))) {
+        return err;
+    }
+    uint32_t long_notifies = (uint32_t)atomic_set(&notifies, 0);
+
+    err = bt_gatt_exchange_mtu(peer_conn, &mtu_params);
+    if (err || (err = step_wait("MTU exchange"))) {
+        return err;
+    }
+
+    /* Reads: whole value each time, long reads included */
+    read_params.single.handle = read_handle;
+    read_bytes = 0;
+    t0 = k_uptime_ticks();
+    for (int i = 0; i < CONFIG_BENCH_GATT_ITERATIONS; i++) {
+        err = bt_gatt_read(peer_conn, &read_params);
+        if (err || (err = step_wait("read"))) {
+            return err;
+        }
+    }
+    uint32_t read_us = elapsed_us(t0);
+    uint32_t read_bytes_single = read_bytes;
+
+    /* Writes: largest payload that fits one ATT PDU. Every write carries
+     * the same value: one change, one notification */
+    uint16_t write_len = MIN(bt_gatt_get_mtu(peer_conn) - 3U, sizeof(payload));
+
+    memset(payload, 'w', sizeof(payload));
+    write_params.length = write_len;
+    t0 = k_uptime_ticks();
+    for (int i = 0; i < CONFIG_BENCH_GATT_ITERATIONS; i++) {
+        err = bt_gatt_write(peer_conn, &write_params);
+        if (err || (err = step_wait("write"))) {
+            return err;
+        }
+    }
+    uint32_t write_us = elapsed_us(t0);
+
+    /* Whole service, now that every value is set */
+    uint32_t svc_us, svc_rtt, svc_multi_us, svc_multi_rtt;
+
+    err = svc_read(false, &svc_us, &svc_rtt);
+    if (err || (err = svc_read(true, &svc_multi_us, &svc_multi_rtt))) {
+        return err;
+    }
+
+    /* Same direction as the writes, over the L2CAP channel */
+    uint32_t coc_us;
+
+    err = coc_stream(&coc_us);
+    if (err) {
+        return err;
+    }
+
+    /* Firmware image into the app's secondary slot, flash writes included */
+    uint32_t dfu_us, dfu_chunks, dfu_buf;
+
+    err = dfu_upload(&dfu_us, &dfu_chunks, &dfu_buf);
+    if (err) {
+        return err;
+    }
+
+    printk("BENCH conn_us=%u pair_us=%u read_Bps=%u write_Bps=%u coc_Bps=%u "
+           "svc_us=%u svc_rtt=%u svc_multi_us=%u svc_multi_rtt=%u "
+           "notifies=%u long_notifies=%u "
+           "dfu_Bps=%u dfu_ms=%u dfu_chunks=%u dfu_buf=%u "
+           "read_ops=%u write_ops=%u mtu=%u coc_mtu=%u coc_mps=%u\n",
+           conn_us, pair_us, rate_bps(read_bytes_single, read_us),
+           rate_bps((uint32_t)write_len * CONFIG_BENCH_GATT_ITERATIONS, write_us),
+           rate_bps(CONFIG_BENCH_COC_BYTES, coc_us),
+           svc_us, svc_rtt, svc_multi_us, svc_multi_rtt,
+           (uint32_t)atomic_get(&notifies), long_notifies,
+           rate_bps(CONFIG_BENCH_DFU_BYTES, dfu_us), dfu_us / USEC_PER_MSEC, dfu_chunks, dfu_buf,
+           (uint32_t)(((uint64_t)CONFIG_BENCH_GATT_ITERATIONS * USEC_PER_SEC) / MAX(read_us, 1U)),
+           (uint32_t)(((uint64_t)CONFIG_BENCH_GATT_ITERATIONS * USEC_PER_SEC) / MAX(write_us, 1U)),
+           bt_gatt_get_mtu(peer_conn), coc_chan.tx.mtu, coc_chan.tx.mps);
+
+    return bt_conn_disconnect(peer_conn, BT_HCI_ERR_REMOTE_USER_TERM_CONN);
+}
+
+int main(void)
+{
+    int err = bt_enable(NULL);
+
+    if (err) {
+        LOG_ERR("[BT] Bluetooth init failed (err %d)", err);
+        return err;
+    }
+
+    bt_conn_auth_cb_register(&auth_cb);
+    bt_conn_auth_info_cb_register(&auth_info_cb);
+
+    err = run_bench();
+    printk("BENCH %s (err %d)\n", err ? "FAILED" : "DONE", err);
+    return err;
+}
@@ -0,0 +1,67 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: Apache-2.0
+"""Turn the output of the "rec dump" shell command into a trace file.
+
+Reads a console capture, concatenates the "REC <hex>" lines of the last dump
+and checks the header (magic, version, record size, count). The file can be
+replayed with: west build -b native_sim bench/replay -- -DREPLAY_TRACE=<file>
+"""
+
+import argparse
+import pathlib
+import re
+import struct
+import sys
+
+REC_RE = re.compile(r"REC ([0-9a-fA-F]+)\s*$")
+MAGIC = 0x52545645
+VERSION = 1
+HDR = struct.Struct("<IBBH")
+KINDS = {0: "btn", 1: "conn", 2: "sec"}
+
+
+def last_dump(text):
+    dumps, data = [], b""
+    for line in text.splitlines():
+        m = REC_RE.search(line)
+        if m:
+            data += bytes.fromhex(m.group(1))
+        elif data:
+            dumps.append(data)
+            data = b""
+    if data:
+        dumps.append(data)
+    return dumps[-1] if dumps else None
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("log", help="console capture containing a rec dump")
+    parser.add_argument("out", help="trace file to write")
+    args = parser.parse_args()
+
+    data = last_dump(pathlib.Path(args.log).read_text(errors="replace"))
+    if not data or len(data) < HDR.size:
+        sys.exit("no rec dump found")
+
+    magic, version, rec_size, count = HDR.unpack_from(data)
+    if magic != MAGIC or version != VERSION:
+        sys.exit(f"not a version {VERSION} trace (magic {magic:#x}, version {version})")
+    if len(data) != HDR.size + count * rec_size:
+        sys.exit(f"truncated dump: {len(data)} bytes for {count} records")
+
+    kinds = {}
+    total_us = 0
+    for i in range(count):
+        dt_us, kind_type = struct.unpack_from("<IB", data, HDR.size + i * rec_size)
+        total_us += dt_us
+        kind = KINDS.get(kind_type >> 4, "?")
+        kinds[kind] = kinds.get(kind, 0) + 1
+
+    pathlib.Path(args.out).write_bytes(data)
+    summary = ", ".join(f"{n} {k}" for k, n in sorted(kinds.items()))
+    print(f"wrote {count} records ({summary}) spanning {total_us / 1e6:.3f} s to {args.out}")
+
+
+if __name__ == "__main__":
+    main()
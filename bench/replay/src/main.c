@@ -0,0 +1,273 @@
+/**
+ * @file main.c
+ * @brief Event storm benchmark of the UI and LED pipelines
+ *
+ * Replays a trace (a synthetic storm, or a capture passed with
+ * -DREPLAY_TRACE) at 1x, 10x, 100x and back to back while main runs the
+ * same loop as the application: button edges go through the GPIO emulator
+ * and the BTN interrupt, BLE events through conn_chan/sec_chan to the UI,
+ * whose state changes drive the LED thread. One BENCH line per speed
+ * reports injection lag, per-channel delivery, drops and queue depth,
+ * debounced presses and the UI loop cost.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/timing/timing.h>
+
+#include <lvgl.h>
+
+#include "BTN.h"
+#include "LED.h"
+
+#include "events.h"
+#include "evt_trace.h"
+#include "led_indicator.h"
+#include "ui.h"
+
+/* ui.c logs to the application module */
+LOG_MODULE_REGISTER(app, CONFIG_APP_LOG_LEVEL);
+
+/* --------------------------------------------------------------------------
+ * Constants
+ * -------------------------------------------------------------------------- */
+#define STORM_RECS_PER_CYCLE 14
+#define STORM_RECS           (CONFIG_BENCH_REPLAY_CYCLES * STORM_RECS_PER_CYCLE)
+
+#define REPLAY_STACK_SIZE 2048
+#define REPLAY_PRIORITY   5
+
+/* --------------------------------------------------------------------------
+ * Types
+ * -------------------------------------------------------------------------- */
+struct bench_chan {
+    const struct zbus_channel *chan;
+    const char                *name;
+    struct evt_chan_stats      before;
+};
+
+/* --------------------------------------------------------------------------
+ * Global States
+ * -------------------------------------------------------------------------- */
+static const uint32_t speedups[] = {1, 10, 100, 0};
+
+static struct bench_chan chans[] = {
+    {.chan = &conn_chan, .name = "conn"},
+    {.chan = &sec_chan,  .name = "sec"},
+    {.chan = &btn_chan,  .name = "btn"},
+    {.chan = &ui_chan,   .name = "ui"},
+};
+
+#ifdef BENCH_REPLAY_FILE
+static const uint8_t trace[] = {
+#include "replay_trace.inc"
+};
+static const char trace_name[] = "file";
+#else
+static uint8_t trace[sizeof(struct evt_trace_hdr) + STORM_RECS * sizeof(struct evt_trace_rec)];
+static const char trace_name[] = "storm";
+#endif
+static size_t trace_len = sizeof(trace);
+
+K_THREAD_STACK_DEFINE(replay_stack, REPLAY_STACK_SIZE);
+static struct k_thread         replay_thread;
+static struct evt_replay_stats replay_stats;
+static uint32_t                replay_speedup;
+static int                     replay_err;
+static atomic_t                replay_done;
+
+static atomic_t btn_presses;
+
+/* --------------------------------------------------------------------------
+ * Private Functions
+ * -------------------------------------------------------------------------- */
+#ifndef BENCH_REPLAY_FILE
+static struct evt_trace_rec *storm_put(struct evt_trace_rec *rec, uint32_t dt_ms,
+                                       evt_trace_kind_t kind, uint8_t type, uint32_t arg)
+{
+    rec->dt_us     = sys_cpu_to_le32(dt_ms * USEC_PER_MSEC);
+    rec->kind_type = (uint8_t)((kind << 4) | type);
+    sys_put_le24(arg, rec->arg);
+    return rec + 1;
+}
+
+/* Connect, passkey, a burst of presses faster than the debounce, encrypt,
+ * pair (fail every fourth time), disconnect */
+static void storm_build(void)
+{
+    struct evt_trace_hdr hdr = {
+        .magic    = sys_cpu_to_le32(EVT_TRACE_MAGIC),
+        .version  = EVT_TRACE_VERSION,
+        .rec_size = sizeof(struct evt_trace_rec),
+        .count    = sys_cpu_to_le16(STORM_RECS),
+    };
+    struct evt_trace_rec *rec = (struct evt_trace_rec *)(trace + sizeof(hdr));
+
+    memcpy(trace, &hdr, sizeof(hdr));
+    for (uint32_t i = 0; i < CONFIG_BENCH_REPLAY_CYCLES; i++) {
+        bool fail = (i % 4) == 3;
+
+        rec = storm_put(rec, 20, EVT_TRACE_CONN, CONN_EVT_CONNECTED, 0);
+        rec = storm_put(rec, 5, EVT_TRACE_SEC, SEC_EVT_PASSKEY, 0);
+        for (uint32_t b = 0; b < 8; b++) {
+            rec = storm_put(rec, 2, EVT_TRACE_BTN, b % NUM_BTNS, 0);
+        }
+        rec = storm_put(rec, 10, EVT_TRACE_SEC, SEC_EVT_LEVEL_CHANGED, fail ? 1 : 4);
+        rec = storm_put(rec, 5, EVT_TRACE_SEC, fail ? SEC_EVT_FAILED : SEC_EVT_PAIRED,
+                        fail ? 4 : 1);
+        rec = storm_put(rec, 30, EVT_TRACE_CONN, CONN_EVT_DISCONNECTED, 0x13);
+        rec = storm_put(rec, 12, EVT_TRACE_BTN, BTN0, 0);
+    }
+}
+#endif
+
+static void btn_pressed(btn_id btn)
+{
+    struct btn_evt evt = {.btn = btn};
+
+    atomic_inc(&btn_presses);
+    evt_publish(&btn_chan, &evt);
+}
+
+static void replay_entry(void *p1, void *p2, void *p3)
+{
+    replay_err = evt_trace_replay(trace, trace_len, replay_speedup, &replay_stats);
+    atomic_set(&replay_done, 1);
+}
+
+static uint32_t trace_btn_edges(void)
+{
+    const struct evt_trace_hdr *hdr = (const struct evt_trace_hdr *)trace;
+    const struct evt_trace_rec *recs = (const struct evt_trace_rec *)(trace + sizeof(*hdr));
+    uint16_t count = sys_le16_to_cpu(hdr->count);
+    uint32_t edges = 0;
+
+    for (uint16_t i = 0; i < count && (sizeof(*hdr) + (i + 1) * sizeof(*recs)) <= trace_len; i++) {
+        edges += ((recs[i].kind_type >> 4) == EVT_TRACE_BTN);
+    }
+    return edges;
+}
+
+static uint32_t elapsed_us(timing_t *start)
+{
+    timing_t end = timing_counter_get();
+
+    return (uint32_t)(timing_cycles_to_ns(timing_cycles_get(start, &end)) / NSEC_PER_USEC);
+}
+
+/* The application's main loop, timed, until the replay ended and the
+ * pipelines had CONFIG_BENCH_REPLAY_SETTLE_MS to drain */
+static void run_ui_loop(uint32_t *frames, uint32_t *loop_max_us, uint64_t *loop_sum_us)
+{
+    int64_t settle_until = -1;
+
+    while (settle_until < 0 || k_uptime_get() < settle_until) {
+        timing_t start = timing_counter_get();
+        uint32_t sleep_ms = lv_task_handler();
+
+        ui_render();
+
+        uint32_t us = elapsed_us(&start);
+
+        (*frames)++;
+        *loop_max_us  = MAX(*loop_max_us, us);
+        *loop_sum_us += us;
+
+        ui_process_events(K_MSEC(MIN(sleep_ms, 10)));
+        if (settle_until < 0 && atomic_get(&replay_done)) {
+            settle_until = k_uptime_get() + CONFIG_BENCH_REPLAY_SETTLE_MS;
+        }
+    }
+}
+
+static void run_replay(uint32_t speedup)
+{
+    static char line[768];
+    struct ui_transition_stats ui_before;
+    struct ui_transition_stats ui_after;
+    uint32_t frames = 0;
+    uint32_t loop_max_us = 0;
+    uint64_t loop_sum_us = 0;
+    uint32_t presses_before = atomic_get(&btn_presses);
+
+    for (size_t i = 0; i < ARRAY_SIZE(chans); i++) {
+        evt_stats_get(chans[i].chan, &chans[i].before);
+    }
+    ui_transition_stats_get(&ui_before);
+
+    replay_speedup = speedup;
+    atomic_clear(&replay_done);
+    k_thread_create(&replay_thread, replay_stack, K_THREAD_STACK_SIZEOF(replay_stack),
+                    replay_entry, NULL, NULL, NULL, REPLAY_PRIORITY, 0, K_NO_WAIT);
+
+    run_ui_loop(&frames, &loop_max_us, &loop_sum_us);
+    k_thread_join(&replay_thread, K_FOREVER);
+    ui_transition_stats_get(&ui_after);
+
+    if (replay_err) {
+        printk("BENCH {\"name\":\"replay\",\"speedup\":%u,\"error\":%d}\n", speedup, replay_err);
+        return;
+    }
+
+    int len = snprintk(line, sizeof(line),
+                       "{\"name\":\"replay\",\"trace\":\"%s\",\"speedup\":%u,"
+                       "\"events\":%u,\"failed\":%u,\"lag_max_us\":%u,\"elapsed_ms\":%u,"
+                       "\"btn_edges\":%u,\"btn_presses\":%u,"
+                       "\"ui_transitions\":%u,\"ui_rejected\":%u,"
+                       "\"frames\":%u,\"loop_avg_us\":%u,\"loop_max_us\":%u",
+                       trace_name, speedup, replay_stats.injected, replay_stats.failed,
+                       replay_stats.lag_max_us, replay_stats.elapsed_us / USEC_PER_MSEC,
+                       trace_btn_edges(), (uint32_t)atomic_get(&btn_presses) - presses_before,
+                       ui_after.transitions - ui_before.transitions,
+                       ui_after.rejected - ui_before.rejected, frames,
+                       frames ? (uint32_t)(loop_sum_us / frames) : 0U, loop_max_us);
+
+    /* Latency maxima and queue depths are since boot: speeds run slow to fast */
+    for (size_t i = 0; i < ARRAY_SIZE(chans); i++) {
+        struct evt_chan_stats st;
+
+        evt_stats_get(chans[i].chan, &st);
+        len += snprintk(line + len, sizeof(line) - len,
+                        ",\"%s\":{\"published\":%u,\"pub_failed\":%u,\"delivered\":%u,"
+                        "\"lat_max_us\":%u,\"queue_max\":%u}",
+                        chans[i].name, st.published - chans[i].before.published,
+                        st.pub_failed - chans[i].before.pub_failed,
+                        st.delivered - chans[i].before.delivered, st.lat_max_us, st.queue_max);
+    }
+    snprintk(line + len, sizeof(line) - len, "}");
+    printk("BENCH %s\n", line);
+}
+
+int main(void)
+{
+#ifndef BENCH_REPLAY_FILE
+    storm_build();
+#endif
+
+    BTN_set_callback(btn_pressed);
+    if (0 > BTN_init() || 0 > LED_init()) {
+        printk("BENCH FAILED driver init\n");
+        return 0;
+    }
+    led_indicator_start();
+
+    if (ui_init()) {
+        printk("BENCH FAILED no display\n");
+        return 0;
+    }
+    ui_render();
+    lv_task_handler();
+
+    timing_init();
+    timing_start();
+
+    for (size_t i = 0; i < ARRAY_SIZE(speedups); i++) {
+        run_replay(speedups[i]);
+    }
+
+    timing_stop();
+    printk("BENCH DONE\n");
+    return 0;
+}
@@ -0,0 +1,132 @@
+/**
+ * @file main.c
+ * @brief Scan report processing benchmark
+ *
+ * Feeds scan_table_report() with synthetic advertising reports from crowds
+ * of increasing size, once with the service UUID filter off and once with
+ * it on. One in eight advertisers carries the secure demo service UUID,
+ * half of the others a foreign 128-bit UUID (some sharing its first byte).
+ * Reports come in batches of CONFIG_BENCH_SCAN_BATCH separated by a short
+ * pause, so devices that went quiet age out like they would on air.
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/bluetooth/gap.h>
+
+#include "scan_table.h"
+#include "secure_svc.h"
+
+/* --------------------------------------------------------------------------
+ * Constants
+ * -------------------------------------------------------------------------- */
+#define BENCH_AD_LEN   31
+#define BENCH_UUID_LEN 16
+
+/* --------------------------------------------------------------------------
+ * Global States
+ * -------------------------------------------------------------------------- */
+static const uint32_t crowds[] = {32, 128, 512, 2048};
+
+static const uint8_t demo_uuid[BENCH_UUID_LEN] = {BT_UUID_SECURE_DEMO_SERVICE_VAL};
+
+static uint32_t rng_state = 0x2545f491;
+
+/* --------------------------------------------------------------------------
+ * Private Functions
+ * -------------------------------------------------------------------------- */
+/* xorshift32, the same sequence on every run */
+static uint32_t rng(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+/* Random static address derived from the device number */
+static void device_addr(uint32_t dev, bt_addr_le_t *addr)
+{
+    uint32_t h = dev * 2654435761U;
+
+    addr->type = BT_ADDR_LE_RANDOM;
+    sys_put_le32(h, &addr->a.val[0]);
+    sys_put_le16((uint16_t)dev, &addr->a.val[4]);
+    addr->a.val[5] |= 0xC0;
+}
+
+/* Flags, an optional 128-bit UUID list and a shortened name, in an
+ * ad buffer of BENCH_AD_LEN + 1 bytes (room for the name terminator) */
+static uint8_t device_ad(uint32_t dev, uint8_t *ad)
+{
+    uint8_t len = 0;
+
+    ad[len++] = 2;
+    ad[len++] = BT_DATA_FLAGS;
+    ad[len++] = BT_LE_AD_GENERAL | BT_LE_AD_NO_BREDR;
+
+    if ((dev % 8) == 0 || (dev % 2) == 1) {
+        ad[len++] = 1 + BENCH_UUID_LEN;
+        ad[len++] = BT_DATA_UUID128_ALL;
+        memcpy(&ad[len], demo_uuid, BENCH_UUID_LEN);
+        if (dev % 8) {
+            /* Foreign service, half of them only differ in the last byte */
+            ad[len + BENCH_UUID_LEN - 1] ^= 0xA5;
+            if (dev % 4 != 1) {
+                sys_put_le32(dev, &ad[len]);
+            }
+        }
+        len += BENCH_UUID_LEN;
+    }
+
+    ad[len++] = 1 + 8;
+    ad[len++] = BT_DATA_NAME_SHORTENED;
+    len += snprintk((char *)&ad[len], BENCH_AD_LEN + 1 - len, "dev%05u", dev % 100000);
+    return len;
+}
+
+static void run_crowd(uint32_t crowd, bool filter)
+{
+    uint8_t ad[BENCH_AD_LEN + 1];
+    struct scan_stats st;
+
+    scan_table_filter_set(filter);
+    scan_table_reset();
+
+    for (uint32_t i = 0; i < CONFIG_BENCH_SCAN_REPORTS; i++) {
+        uint32_t dev = rng() % crowd;
+        bt_addr_le_t addr;
+        uint8_t len = device_ad(dev, ad);
+
+        device_addr(dev, &addr);
+        scan_table_report(&addr, -30 - (int8_t)(rng() % 70), ad, len);
+
+        if ((i + 1) % CONFIG_BENCH_SCAN_BATCH == 0) {
+            k_msleep(CONFIG_BENCH_SCAN_GAP_MS);
+        }
+    }
+
+    scan_table_stats_get(&st);
+
+    uint64_t ns = MAX(k_cyc_to_ns_floor64(st.cycles), 1);
+
+    printk("BENCH {\"name\":\"scan\",\"crowd\":%u,\"filter\":%s,\"table\":%u,"
+           "\"reports\":%u,\"ns_per_report\":%u,\"reports_per_s\":%u,"
+           "\"new\":%u,\"filtered\":%u,\"evicted\":%u,\"dropped\":%u,\"probes_max\":%u}\n",
+           crowd, filter ? "true" : "false", CONFIG_APP_SCAN_TABLE_SIZE, st.reports,
+           (uint32_t)(ns / st.reports), (uint32_t)(((uint64_t)st.reports * NSEC_PER_SEC) / ns),
+           st.new_devices, st.filtered, st.evicted, st.dropped, st.probes_max);
+}
+
+int main(void)
+{
+    for (size_t i = 0; i < ARRAY_SIZE(crowds); i++) {
+        run_crowd(crowds[i], false);
+        run_crowd(crowds[i], true);
+    }
+    printk("BENCH DONE\n");
+    return 0;
+}
@@ -0,0 +1,65 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: Apache-2.0
+"""Compare the UI benchmark frame CRCs with frames.golden.
+
+Reads the BENCH lines from a console log (handler.log) or the recordings in
+a twister.json and fails when a frame differs from the golden CRC or was not
+stable across passes. Run with --update after an intended UI change.
+"""
+
+import argparse
+import json
+import pathlib
+import re
+import sys
+
+GOLDEN = pathlib.Path(__file__).with_name("frames.golden")
+BENCH_RE = re.compile(r"BENCH (\{.*\})")
+
+
+def load_results(path):
+    text = pathlib.Path(path).read_text()
+    if path.endswith(".json"):
+        results = []
+        for suite in json.loads(text).get("testsuites", []):
+            if suite.get("name", "").endswith("bench.ui"):
+                results += [rec["result"] for rec in suite.get("recording", [])]
+        return results
+    return [json.loads(m.group(1)) for m in BENCH_RE.finditer(text)]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("log", help="handler.log or twister.json")
+    parser.add_argument("--update", action="store_true",
+                        help="write the current CRCs to frames.golden")
+    args = parser.parse_args()
+
+    frames = {f"{r['step']}:{r['from']}->{r['to']}": r for r in load_results(args.log)
+              if "step" in r}
+    if not frames:
+        sys.exit("no BENCH results found")
+
+    if args.update:
+        GOLDEN.write_text(json.dumps({k: r["crc"] for k, r in frames.items()},
+                                     indent=2) + "\n")
+        print(f"wrote {len(frames)} frames to {GOLDEN}")
+        return
+
+    golden = json.loads(GOLDEN.read_text()) if GOLDEN.exists() else {}
+    failed = False
+    for key, r in frames.items():
+        if r["crc_mismatch"]:
+            print(f"UNSTABLE {key}: {r['crc_mismatch']} passes rendered differently")
+            failed = True
+        if key not in golden:
+            print(f"NEW      {key}: {r['crc']} (run with --update)")
+            failed = True
+        elif golden[key] != r["crc"]:
+            print(f"CHANGED  {key}: {golden[key]} -> {r['crc']}")
+            failed = True
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()
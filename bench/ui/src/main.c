@@ -0,0 +1,203 @@
+/**
+ * @file main.c
+ * @brief Headless frame-time benchmark of the application UI
+ *
+ * Drives the UI state machine through every edge of its transition table
+ * CONFIG_BENCH_UI_CYCLES times. For each transition it measures dispatch,
+ * ui_render() and lv_task_handler() time, the area flushed to the display,
+ * LVGL heap usage and a CRC of the resulting frame. A frame whose CRC varies
+ * between passes is reported, and check_frames.py compares the CRCs with
+ * the committed golden values.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/timing/timing.h>
+
+#include <lvgl.h>
+#include <lvgl_mem.h>
+
+#include "mem_display.h"
+#include "ui.h"
+
+/* ui.c logs to the application module */
+LOG_MODULE_REGISTER(app, CONFIG_APP_LOG_LEVEL);
+
+/* --------------------------------------------------------------------------
+ * Types
+ * -------------------------------------------------------------------------- */
+struct bench_step {
+    ui_event_t ev;
+    uint32_t   passkey;
+    ui_state_t to; /* expected state after ev */
+};
+
+struct bench_acc {
+    uint64_t sum;
+    uint32_t min;
+    uint32_t max;
+};
+
+struct bench_result {
+    struct bench_acc dispatch_ns;
+    struct bench_acc render_ns;
+    struct bench_acc task_ns;
+    struct bench_acc pixels;
+    uint32_t         heap_max;
+    uint32_t         crc;
+    uint32_t         crc_mismatch;
+};
+
+/* --------------------------------------------------------------------------
+ * Global States
+ * -------------------------------------------------------------------------- */
+/* Every edge of ui_transitions[], starting and ending on advertising */
+static const struct bench_step steps[] = {
+    {UI_EV_CONNECTED,    0,      UI_STATE_CONNECTED},
+    {UI_EV_PASSKEY,      123456, UI_STATE_PASSKEY},
+    {UI_EV_PASSKEY,      654321, UI_STATE_PASSKEY},
+    {UI_EV_FAILED,       0,      UI_STATE_PAIR_FAILED},
+    {UI_EV_PASSKEY,      111111, UI_STATE_PASSKEY},
+    {UI_EV_PAIRED,       0,      UI_STATE_PAIRED},
+    {UI_EV_FAILED,       0,      UI_STATE_PAIR_FAILED},
+    {UI_EV_PAIRED,       0,      UI_STATE_PAIRED},
+    {UI_EV_DISCONNECTED, 0,      UI_STATE_ADVERTISING},
+    {UI_EV_CONNECTED,    0,      UI_STATE_CONNECTED},
+    {UI_EV_PAIRED,       0,      UI_STATE_PAIRED},
+    {UI_EV_DISCONNECTED, 0,      UI_STATE_ADVERTISING},
+    {UI_EV_CONNECTED,    0,      UI_STATE_CONNECTED},
+    {UI_EV_FAILED,       0,      UI_STATE_PAIR_FAILED},
+    {UI_EV_DISCONNECTED, 0,      UI_STATE_ADVERTISING},
+};
+
+static const char *const state_names[UI_STATE_COUNT] = {
+    [UI_STATE_ADVERTISING] = "advertising",
+    [UI_STATE_CONNECTED]   = "connected",
+    [UI_STATE_PASSKEY]     = "passkey",
+    [UI_STATE_PAIRED]      = "paired",
+    [UI_STATE_PAIR_FAILED] = "pair_failed",
+};
+
+static const struct device *const display = DEVICE_DT_GET(DT_CHOSEN(zephyr_display));
+
+static struct bench_result results[ARRAY_SIZE(steps)];
+
+/* --------------------------------------------------------------------------
+ * Private Functions
+ * -------------------------------------------------------------------------- */
+static void acc_add(struct bench_acc *acc, uint32_t v, bool first)
+{
+    acc->min  = first ? v : MIN(acc->min, v);
+    acc->max  = MAX(acc->max, v);
+    acc->sum += v;
+}
+
+static uint32_t elapsed_ns(timing_t *start)
+{
+    timing_t end = timing_counter_get();
+
+    return (uint32_t)timing_cycles_to_ns(timing_cycles_get(start, &end));
+}
+
+static int run_step(size_t i, bool first)
+{
+    const struct bench_step *s = &steps[i];
+    struct bench_result *r = &results[i];
+    mem_display_stats before;
+    mem_display_stats after;
+    struct sys_memory_stats heap;
+    timing_t t;
+
+    mem_display_stats_get(display, &before);
+
+    t = timing_counter_get();
+    if (ui_dispatch(s->ev, s->passkey) || ui_state_get() != s->to) {
+        printk("BENCH FAILED step %u ended in %s\n", (unsigned int)i,
+               state_names[ui_state_get()]);
+        return -EINVAL;
+    }
+    acc_add(&r->dispatch_ns, elapsed_ns(&t), first);
+
+    t = timing_counter_get();
+    ui_render();
+    acc_add(&r->render_ns, elapsed_ns(&t), first);
+
+    t = timing_counter_get();
+    lv_task_handler();
+    acc_add(&r->task_ns, elapsed_ns(&t), first);
+
+    mem_display_stats_get(display, &after);
+    acc_add(&r->pixels, (uint32_t)(after.pixels - before.pixels), first);
+
+    lvgl_heap_stats(&heap);
+    r->heap_max = MAX(r->heap_max, (uint32_t)heap.allocated_bytes);
+
+    uint32_t crc = mem_display_checksum(display);
+
+    if (first) {
+        r->crc = crc;
+    } else if (crc != r->crc) {
+        r->crc_mismatch++;
+    }
+    return 0;
+}
+
+/* One BENCH line per step, built in full so it can't be interleaved */
+static void print_result(size_t i, ui_state_t from)
+{
+    static char line[512];
+    const struct bench_result *r = &results[i];
+    const struct bench_acc *accs[] = {
+        &r->dispatch_ns, &r->render_ns, &r->task_ns, &r->pixels,
+    };
+    static const char *const acc_names[] = {
+        "dispatch_ns", "render_ns", "task_ns", "pixels",
+    };
+    int len = snprintk(line, sizeof(line),
+                       "{\"step\":%u,\"from\":\"%s\",\"to\":\"%s\",\"n\":%u",
+                       (unsigned int)i, state_names[from], state_names[steps[i].to],
+                       CONFIG_BENCH_UI_CYCLES);
+
+    for (size_t a = 0; a < ARRAY_SIZE(accs); a++) {
+        len += snprintk(line + len, sizeof(line) - len,
+                        ",\"%s\":{\"min\":%u,\"avg\":%u,\"max\":%u}", acc_names[a],
+                        accs[a]->min, (uint32_t)(accs[a]->sum / CONFIG_BENCH_UI_CYCLES),
+                        accs[a]->max);
+    }
+    snprintk(line + len, sizeof(line) - len,
+             ",\"heap_max\":%u,\"crc\":\"%08x\",\"crc_mismatch\":%u}",
+             r->heap_max, r->crc, r->crc_mismatch);
+    printk("BENCH %s\n", line);
+}
+
+int main(void)
+{
+    if (!device_is_ready(display) || ui_init()) {
+        printk("BENCH FAILED no display\n");
+        return 0;
+    }
+
+    /* First frame (advertising) in full, outside the measurement */
+    ui_render();
+    lv_task_handler();
+
+    for (uint32_t cycle = 0; cycle < CONFIG_BENCH_UI_CYCLES; cycle++) {
+        for (size_t i = 0; i < ARRAY_SIZE(steps); i++) {
+            if (run_step(i, cycle == 0)) {
+                return 0;
+            }
+        }
+    }
+
+    ui_state_t from = UI_STATE_ADVERTISING;
+
+    for (size_t i = 0; i < ARRAY_SIZE(steps); i++) {
+        print_result(i, from);
+        from = steps[i].to;
+    }
+
+    printk("BENCH DONE\n");
+    return 0;
+}
@@ -7,6 +7,11 @@ Header to define button interface
 
 #include <stdbool.h>
 
+/* ----------------------------------------------------------------------------
+                                  CONSTANTS
+---------------------------------------------------------------------------- */
+#define BTN_DEBOUNCE_MS   20 // A press is recorded once the pin has been stable this long
+
 /* ----------------------------------------------------------------------------
                                     TYPES
 ---------------------------------------------------------------------------- */
@@ -18,6 +23,10 @@ typedef enum btn_id_t {
   NUM_BTNS,
 } btn_id;
 
+typedef void (*btn_callback)(btn_id btn);
+
+typedef void (*btn_edge_callback)(btn_id btn);
+
 /* ----------------------------------------------------------------------------
                               Public Functions
 ---------------------------------------------------------------------------- */
@@ -31,4 +40,8 @@ bool BTN_check_pressed(btn_id btn);
 
 void BTN_clear_pressed(btn_id btn);
 
+void BTN_set_callback(btn_callback cb);
+
+void BTN_set_edge_callback(btn_edge_callback cb);
+
 #endif
\ No newline at end of file
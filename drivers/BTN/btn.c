@@ -5,15 +5,12 @@ Header to define button module logic
 #include <zephyr/kernel.h>
 #include <zephyr/device.h>
 #include <zephyr/drivers/gpio.h>
-#include <zephyr/sys/printk.h>
+#include <zephyr/logging/log.h>
 #include <inttypes.h>
 
 #include "BTN.h"
 
-/* ----------------------------------------------------------------------------
-                                    Constants
----------------------------------------------------------------------------- */
-#define BTN_DEBOUNCE_MS   20
+LOG_MODULE_REGISTER(BTN, CONFIG_LOG_DEFAULT_LEVEL);
 
 /* ----------------------------------------------------------------------------
                                   Macro Helpers
@@ -30,6 +27,7 @@ Header to define button module logic
 ---------------------------------------------------------------------------- */
 typedef struct btn_gpio_t {
   struct gpio_dt_spec spec; 
+  btn_id id;
   volatile bool pressed;
   struct gpio_callback cb;
   struct k_work_delayable work;
@@ -47,12 +45,15 @@ static void _btn_debounce(struct k_work *work);
 /* ----------------------------------------------------------------------------
                                 Global States
 ---------------------------------------------------------------------------- */
-static btn_gpio _btn0 = {.spec=GPIO_DT_SPEC_GET(BTN0_NODE, gpios), .pressed=false};
-static btn_gpio _btn1 = {.spec=GPIO_DT_SPEC_GET(BTN1_NODE, gpios), .pressed=false};
-static btn_gpio _btn2 = {.spec=GPIO_DT_SPEC_GET(BTN2_NODE, gpios), .pressed=false};
-static btn_gpio _btn3 = {.spec=GPIO_DT_SPEC_GET(BTN3_NODE, gpios), .pressed=false};
+static btn_gpio _btn0 = {.spec=GPIO_DT_SPEC_GET(BTN0_NODE, gpios), .id=BTN0, .pressed=false};
+static btn_gpio _btn1 = {.spec=GPIO_DT_SPEC_GET(BTN1_NODE, gpios), .id=BTN1, .pressed=false};
+static btn_gpio _btn2 = {.spec=GPIO_DT_SPEC_GET(BTN2_NODE, gpios), .id=BTN2, .pressed=false};
+static btn_gpio _btn3 = {.spec=GPIO_DT_SPEC_GET(BTN3_NODE, gpios), .id=BTN3, .pressed=false};
 static btn_gpio *_btns[NUM_BTNS] = {&_btn0, &_btn1, &_btn2, &_btn3};
 
+static btn_callback _btn_cb = NULL;
+static btn_edge_callback _btn_edge_cb = NULL;
+
 /* ----------------------------------------------------------------------------
                               Private Functions
 ---------------------------------------------------------------------------- */
@@ -88,6 +89,9 @@ static int _btn_config(btn_gpio *btn) {
 static void _btn_interrupt_service_routine(const struct device *dev, struct gpio_callback *cb, uint32_t pins) {
   for (uint8_t i = 0; i < NUM_BTNS; i++) {
     if (pins & BIT(_btns[i]->spec.pin)) {
+      if (_btn_edge_cb) {
+        _btn_edge_cb(_btns[i]->id);
+      }
       k_work_reschedule(&_btns[i]->work, K_MSEC(BTN_DEBOUNCE_MS));
     }
   }
@@ -105,6 +109,9 @@ static void _btn_debounce(struct k_work *_work) {
 
   if (gpio_pin_get_dt(&btn->spec)) {
     btn->pressed = true;
+    if (_btn_cb) {
+      _btn_cb(btn->id);
+    }
   }
 }
 
@@ -120,6 +127,7 @@ int BTN_init() {
   for (uint8_t i = 0; i < NUM_BTNS; i++) {
     int rv = _btn_config(_btns[i]);
     if (rv < 0) {
+      LOG_ERR("BTN%u config failed (err %d)", i, rv);
       return rv;
     }
   }
@@ -189,3 +197,23 @@ void BTN_clear_pressed(btn_id btn) {
     return;
   }
 }
+
+/**
+ * @brief Registers a function to call (from the system workqueue) each time a
+ *        debounced press is detected, in addition to setting the pressed flag
+ * 
+ * @param [in] cb The function to call, NULL to unregister
+ */
+void BTN_set_callback(btn_callback cb) {
+  _btn_cb = cb;
+}
+
+/**
+ * @brief Registers a function to call from the interrupt for every raw edge
+ *        to the active state, before debouncing (e.g. to record them)
+ * 
+ * @param [in] cb The function to call, NULL to unregister. Must be ISR safe
+ */
+void BTN_set_edge_callback(btn_edge_callback cb) {
+  _btn_edge_cb = cb;
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+/*
+Header to define the FT6206 touch controller interface
+*/
+
+#ifndef FT6206_H
+#define FT6206_H
+
+#include <stdint.h>
+#include <zephyr/device.h>
+#include <lvgl.h>
+
+/* ----------------------------------------------------------------------------
+                                    TYPES
+---------------------------------------------------------------------------- */
+typedef struct ft6206_stats_t {
+  uint32_t irqs;            // Interrupt edges seen
+  uint32_t reads;           // I2C reads of the touch registers
+  uint32_t read_errors;
+  uint32_t samples;         // Samples handed to LVGL
+  uint32_t coalesced;       // Samples merged into a queued one
+  uint32_t dropped;         // Samples lost to a full queue
+  uint32_t read_lat_max_us; // Interrupt to sample queued
+  uint32_t lat_min_us;      // Interrupt to LVGL read
+  uint32_t lat_max_us;
+  uint32_t lat_avg_us;
+} ft6206_stats;
+
+/* ----------------------------------------------------------------------------
+                              Public Functions
+---------------------------------------------------------------------------- */
+lv_indev_t *ft6206_lvgl_register(const struct device *dev);
+
+void ft6206_stats_get(const struct device *dev, ft6206_stats *stats);
+
+void ft6206_stats_reset(const struct device *dev);
+
+#endif
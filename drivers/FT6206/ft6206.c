@@ -0,0 +1,327 @@
+/*
+FT6206 capacitive touch controller, interrupt driven LVGL pointer input
+*/
+
+#define DT_DRV_COMPAT eie_ft6206
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/logging/log.h>
+#include <lvgl.h>
+
+#include "FT6206.h"
+
+LOG_MODULE_REGISTER(FT6206, CONFIG_LOG_DEFAULT_LEVEL);
+
+/* ----------------------------------------------------------------------------
+                                    Constants
+---------------------------------------------------------------------------- */
+#define FT6206_REG_TD_STATUS      0x02 // Number of touch points, followed by P1
+#define FT6206_REG_G_MODE         0xA4
+#define FT6206_REG_VENDOR_ID      0xA8
+
+#define FT6206_VENDOR_ID          0x11
+#define FT6206_G_MODE_TRIGGER     0x01 // INT pulses once per report
+#define FT6206_EVENT_LIFT_UP      0x01
+#define FT6206_MAX_POINTS         2
+
+#define FT6206_QUEUE_LEN          CONFIG_EIE_FT6206_QUEUE_LEN
+
+/* ----------------------------------------------------------------------------
+                                    Types
+---------------------------------------------------------------------------- */
+typedef struct ft6206_sample_t {
+  uint16_t x;
+  uint16_t y;
+  bool pressed;
+  uint32_t irq_cycles; // Interrupt that produced the sample
+} ft6206_sample;
+
+typedef struct ft6206_config_t {
+  struct i2c_dt_spec bus;
+  struct gpio_dt_spec int_gpio;
+  uint16_t width; // Panel size, used for inversion
+  uint16_t height;
+  bool swap_xy;
+  bool invert_x;
+  bool invert_y;
+} ft6206_config;
+
+typedef struct ft6206_data_t {
+  const struct device *dev;
+  struct gpio_callback int_cb;
+  struct k_work work;
+  struct k_spinlock lock;
+  bool irq_pending; // irq_cycles holds an interrupt not read yet
+  uint32_t irq_cycles;
+  ft6206_sample queue[FT6206_QUEUE_LEN];
+  uint8_t head;
+  uint8_t count;
+  ft6206_sample last; // Last sample handed to LVGL
+  uint16_t press_x; // Last pressed point read, releases are reported there
+  uint16_t press_y;
+  ft6206_stats stats;
+  uint64_t lat_sum_us;
+} ft6206_data;
+
+/* ----------------------------------------------------------------------------
+                            Private Function Prototypes
+---------------------------------------------------------------------------- */
+static void _ft6206_interrupt_service_routine(const struct device *port, struct gpio_callback *cb, uint32_t pins);
+
+static void _ft6206_read_work(struct k_work *work);
+
+static void _ft6206_push(ft6206_data *data, const ft6206_sample *sample);
+
+static void _ft6206_lvgl_read(lv_indev_t *indev, lv_indev_data_t *out);
+
+/* ----------------------------------------------------------------------------
+                              Private Functions
+---------------------------------------------------------------------------- */
+/**
+ * @brief Invoked when the controller pulls INT low. Only timestamps the edge
+ *        and defers the I2C read, edges arriving before it runs share one read
+ *
+ * @param [in] port The GPIO port that triggered the interrupt
+ * @param [in] cb The int_cb member of the instance's ft6206_data
+ * @param [in] pins A bitmask for all the GPIO pins that triggered this interrupt
+ */
+static void _ft6206_interrupt_service_routine(const struct device *port, struct gpio_callback *cb, uint32_t pins) {
+  ft6206_data *data = CONTAINER_OF(cb, ft6206_data, int_cb);
+  k_spinlock_key_t key = k_spin_lock(&data->lock);
+
+  data->stats.irqs++;
+  if (!data->irq_pending) {
+    data->irq_pending = true;
+    data->irq_cycles = k_cycle_get_32();
+  }
+  k_spin_unlock(&data->lock, key);
+  k_work_submit(&data->work);
+}
+
+/**
+ * @brief Reads the first touch point and queues it for LVGL, a release at the
+ *        last pressed point
+ *
+ * @param [in] work The work member of the instance's ft6206_data
+ */
+static void _ft6206_read_work(struct k_work *work) {
+  ft6206_data *data = CONTAINER_OF(work, ft6206_data, work);
+  const ft6206_config *config = data->dev->config;
+  uint8_t buf[5]; // TD_STATUS, P1_XH, P1_XL, P1_YH, P1_YL
+  ft6206_sample sample;
+  k_spinlock_key_t key = k_spin_lock(&data->lock);
+
+  // Anything arriving from here on needs another read
+  sample.irq_cycles = data->irq_cycles;
+  data->irq_pending = false;
+  data->stats.reads++;
+  k_spin_unlock(&data->lock, key);
+
+  if (0 > i2c_burst_read_dt(&config->bus, FT6206_REG_TD_STATUS, buf, sizeof(buf))) {
+    key = k_spin_lock(&data->lock);
+    data->stats.read_errors++;
+    k_spin_unlock(&data->lock, key);
+    return;
+  }
+
+  uint8_t points = buf[0] & 0x0F;
+  uint16_t x = ((buf[1] & 0x0F) << 8) | buf[2];
+  uint16_t y = ((buf[3] & 0x0F) << 8) | buf[4];
+
+  sample.pressed = points > 0 && points <= FT6206_MAX_POINTS && (buf[1] >> 6) != FT6206_EVENT_LIFT_UP;
+  if (config->invert_x && x < config->width) {
+    x = config->width - 1 - x;
+  }
+  if (config->invert_y && y < config->height) {
+    y = config->height - 1 - y;
+  }
+
+  key = k_spin_lock(&data->lock);
+  if (sample.pressed) {
+    data->press_x = config->swap_xy ? y : x;
+    data->press_y = config->swap_xy ? x : y;
+  }
+  // Once the finger is up the point registers are stale, release where it was
+  sample.x = data->press_x;
+  sample.y = data->press_y;
+  _ft6206_push(data, &sample);
+  data->stats.read_lat_max_us = MAX(data->stats.read_lat_max_us,
+                                    k_cyc_to_us_floor32(k_cycle_get_32() - sample.irq_cycles));
+  k_spin_unlock(&data->lock, key);
+}
+
+/**
+ * @brief Queues a sample for LVGL. Moves while pressed replace the newest
+ *        queued move so only press/release edges and the latest position
+ *        wait for LVGL. Call with the lock held
+ *
+ * @param [in] data The instance
+ * @param [in] sample The sample to queue
+ */
+static void _ft6206_push(ft6206_data *data, const ft6206_sample *sample) {
+  ft6206_sample *tail = data->count ?
+                        &data->queue[(data->head + data->count - 1) % FT6206_QUEUE_LEN] : &data->last;
+
+  if (sample->pressed == tail->pressed && (!sample->pressed || data->count)) {
+    // Release repeated, or a move that LVGL hasn't seen the previous one of yet
+    if (data->count) {
+      tail->x = sample->x;
+      tail->y = sample->y;
+    }
+    data->stats.coalesced++;
+    return;
+  }
+
+  if (data->count == FT6206_QUEUE_LEN) {
+    *tail = *sample;
+    data->stats.dropped++;
+    return;
+  }
+  data->queue[(data->head + data->count) % FT6206_QUEUE_LEN] = *sample;
+  data->count++;
+}
+
+/**
+ * @brief LVGL read callback, hands over one queued sample per call
+ *
+ * @param [in] indev The indev created by ft6206_lvgl_register()
+ * @param [out] out Pointer state for LVGL
+ */
+static void _ft6206_lvgl_read(lv_indev_t *indev, lv_indev_data_t *out) {
+  const struct device *dev = lv_indev_get_driver_data(indev);
+  ft6206_data *data = dev->data;
+  k_spinlock_key_t key = k_spin_lock(&data->lock);
+
+  if (data->count) {
+    uint32_t lat_us;
+
+    data->last = data->queue[data->head];
+    data->head = (data->head + 1) % FT6206_QUEUE_LEN;
+    data->count--;
+
+    lat_us = k_cyc_to_us_floor32(k_cycle_get_32() - data->last.irq_cycles);
+    data->stats.lat_min_us = data->stats.samples ? MIN(data->stats.lat_min_us, lat_us) : lat_us;
+    data->stats.lat_max_us = MAX(data->stats.lat_max_us, lat_us);
+    data->lat_sum_us += lat_us;
+    data->stats.samples++;
+  }
+
+  out->point.x = data->last.x;
+  out->point.y = data->last.y;
+  out->state = data->last.pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+  out->continue_reading = data->count > 0;
+  k_spin_unlock(&data->lock, key);
+}
+
+/**
+ * @brief Checks the controller, sets trigger mode and enables the interrupt
+ *
+ * @param [in] dev The ft6206 instance
+ *
+ * @return Error code, < 0 on failures
+ */
+static int _ft6206_init(const struct device *dev) {
+  const ft6206_config *config = dev->config;
+  ft6206_data *data = dev->data;
+  uint8_t vendor;
+
+  data->dev = dev;
+  k_work_init(&data->work, _ft6206_read_work);
+
+  if (!i2c_is_ready_dt(&config->bus) || !gpio_is_ready_dt(&config->int_gpio)) {
+    return -ENODEV;
+  } else if (0 > i2c_reg_read_byte_dt(&config->bus, FT6206_REG_VENDOR_ID, &vendor)) {
+    return -EIO;
+  } else if (vendor != FT6206_VENDOR_ID) {
+    LOG_ERR("Unexpected vendor id 0x%02x", vendor);
+    return -ENODEV;
+  } else if (0 > i2c_reg_write_byte_dt(&config->bus, FT6206_REG_G_MODE, FT6206_G_MODE_TRIGGER)) {
+    return -EIO;
+  } else if (0 > gpio_pin_configure_dt(&config->int_gpio, GPIO_INPUT)) {
+    return -EIO;
+  }
+
+  gpio_init_callback(&data->int_cb, _ft6206_interrupt_service_routine, BIT(config->int_gpio.pin));
+  if (0 > gpio_add_callback(config->int_gpio.port, &data->int_cb)) {
+    return -EIO;
+  }
+  return gpio_pin_interrupt_configure_dt(&config->int_gpio, GPIO_INT_EDGE_TO_ACTIVE);
+}
+
+/* ----------------------------------------------------------------------------
+                              Public Functions
+---------------------------------------------------------------------------- */
+/**
+ * @brief Creates the LVGL pointer input device. Call from the thread running
+ *        LVGL, after it is initialised
+ *
+ * @param [in] dev The ft6206 instance
+ *
+ * @return The new indev, NULL on failures
+ */
+lv_indev_t *ft6206_lvgl_register(const struct device *dev) {
+  if (!device_is_ready(dev)) {
+    return NULL;
+  }
+
+  lv_indev_t *indev = lv_indev_create();
+
+  if (indev) {
+    lv_indev_set_type(indev, LV_INDEV_TYPE_POINTER);
+    lv_indev_set_read_cb(indev, _ft6206_lvgl_read);
+    lv_indev_set_driver_data(indev, (void *)dev);
+  }
+  return indev;
+}
+
+/**
+ * @brief Copies the instance's counters and latencies
+ *
+ * @param [in] dev The ft6206 instance
+ * @param [out] stats Destination
+ */
+void ft6206_stats_get(const struct device *dev, ft6206_stats *stats) {
+  ft6206_data *data = dev->data;
+  k_spinlock_key_t key = k_spin_lock(&data->lock);
+
+  *stats = data->stats;
+  stats->lat_avg_us = data->stats.samples ? (uint32_t)(data->lat_sum_us / data->stats.samples) : 0;
+  k_spin_unlock(&data->lock, key);
+}
+
+/**
+ * @brief Clears the instance's counters and latencies
+ *
+ * @param [in] dev The ft6206 instance
+ */
+void ft6206_stats_reset(const struct device *dev) {
+  ft6206_data *data = dev->data;
+  k_spinlock_key_t key = k_spin_lock(&data->lock);
+
+  data->stats = (ft6206_stats){0};
+  data->lat_sum_us = 0;
+  k_spin_unlock(&data->lock, key);
+}
+
+/* ----------------------------------------------------------------------------
+                                  Instances
+---------------------------------------------------------------------------- */
+#define FT6206_DEFINE(n)                                                            \
+  static const ft6206_config _ft6206_config_##n = {                                 \
+    .bus = I2C_DT_SPEC_INST_GET(n),                                                 \
+    .int_gpio = GPIO_DT_SPEC_INST_GET(n, int_gpios),                                \
+    .width = DT_INST_PROP_OR(n, screen_width, 0),                                   \
+    .height = DT_INST_PROP_OR(n, screen_height, 0),                                 \
+    .swap_xy = DT_INST_PROP(n, swapped_x_y),                                        \
+    .invert_x = DT_INST_PROP(n, inverted_x),                                        \
+    .invert_y = DT_INST_PROP(n, inverted_y),                                        \
+  };                                                                                \
+  static ft6206_data _ft6206_data_##n;                                              \
+  DEVICE_DT_INST_DEFINE(n, _ft6206_init, NULL, &_ft6206_data_##n,                   \
+                        &_ft6206_config_##n, POST_KERNEL,                           \
+                        CONFIG_EIE_FT6206_INIT_PRIORITY, NULL);
+
+DT_INST_FOREACH_STATUS_OKAY(FT6206_DEFINE)
@@ -0,0 +1,171 @@
+/*
+FT6206 emulator for Zephyr's I2C emulation controller
+*/
+
+#define DT_DRV_COMPAT eie_ft6206
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/emul.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/drivers/i2c_emul.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/gpio/gpio_emul.h>
+
+#include "ft6206_emul.h"
+
+/* ----------------------------------------------------------------------------
+                                    Constants
+---------------------------------------------------------------------------- */
+#define FT6206_EMUL_REG_TD_STATUS   0x02
+#define FT6206_EMUL_REG_P1_XH       0x03
+#define FT6206_EMUL_REG_CHIP_ID     0xA3
+#define FT6206_EMUL_REG_VENDOR_ID   0xA8
+
+#define FT6206_EMUL_EVENT_DOWN      0x00
+#define FT6206_EMUL_EVENT_UP        0x01
+#define FT6206_EMUL_EVENT_CONTACT   0x02
+
+/* ----------------------------------------------------------------------------
+                                    Types
+---------------------------------------------------------------------------- */
+typedef struct ft6206_emul_config_t {
+  struct gpio_dt_spec int_gpio;
+} ft6206_emul_config;
+
+typedef struct ft6206_emul_data_t {
+  struct k_spinlock lock;
+  uint8_t regs[256];
+  bool pressed;
+  uint32_t read_count; // Reads of TD_STATUS
+} ft6206_emul_data;
+
+/* ----------------------------------------------------------------------------
+                              Private Functions
+---------------------------------------------------------------------------- */
+/**
+ * @brief Drives the (active low) interrupt line
+ *
+ * @param [in] target The emulator
+ * @param [in] active true to assert
+ */
+static void _ft6206_emul_int(const struct emul *target, bool active) {
+  const ft6206_emul_config *config = target->cfg;
+
+  gpio_emul_input_set(config->int_gpio.port, config->int_gpio.pin, active ? 0 : 1);
+}
+
+/**
+ * @brief Register file access. A write sets the register pointer and stores
+ *        any following bytes, a read auto-increments from the pointer.
+ *        Reading TD_STATUS releases the interrupt line
+ *
+ * @param [in] target The emulator
+ * @param [in] msgs The messages of the transfer
+ * @param [in] num_msgs Number of messages
+ * @param [in] addr Target address
+ *
+ * @return Error code, < 0 on failures
+ */
+static int _ft6206_emul_transfer(const struct emul *target, struct i2c_msg *msgs, int num_msgs, int addr) {
+  ft6206_emul_data *data = target->data;
+  uint8_t reg = 0;
+
+  k_spinlock_key_t key = k_spin_lock(&data->lock);
+
+  for (int i = 0; i < num_msgs; i++) {
+    struct i2c_msg *msg = &msgs[i];
+
+    if (msg->flags & I2C_MSG_READ) {
+      if (reg <= FT6206_EMUL_REG_TD_STATUS && reg + msg->len > FT6206_EMUL_REG_TD_STATUS) {
+        data->read_count++;
+        _ft6206_emul_int(target, false);
+      }
+      for (uint32_t j = 0; j < msg->len; j++) {
+        msg->buf[j] = data->regs[reg++];
+      }
+    } else if (msg->len > 0) {
+      reg = msg->buf[0];
+      for (uint32_t j = 1; j < msg->len; j++) {
+        data->regs[reg++] = msg->buf[j];
+      }
+    }
+  }
+  k_spin_unlock(&data->lock, key);
+  return 0;
+}
+
+static int _ft6206_emul_init(const struct emul *target, const struct device *parent) {
+  const ft6206_emul_config *config = target->cfg;
+  ft6206_emul_data *data = target->data;
+
+  data->regs[FT6206_EMUL_REG_VENDOR_ID] = 0x11;
+  data->regs[FT6206_EMUL_REG_CHIP_ID] = 0x06;
+  data->regs[FT6206_EMUL_REG_TD_STATUS] = 0;
+
+  if (!gpio_is_ready_dt(&config->int_gpio)) {
+    return -ENODEV;
+  }
+  _ft6206_emul_int(target, false);
+  return 0;
+}
+
+static const struct i2c_emul_api _ft6206_emul_api = {
+  .transfer = _ft6206_emul_transfer,
+};
+
+/* ----------------------------------------------------------------------------
+                              Public Functions
+---------------------------------------------------------------------------- */
+/**
+ * @brief Reports a touch (or lift) at raw panel coordinates and asserts the
+ *        interrupt line. Reports made before the driver reads are merged,
+ *        like on the real controller
+ *
+ * @param [in] target The ft6206 emulator
+ * @param [in] x Raw panel x, on a lift whatever the stale point registers hold
+ * @param [in] y Raw panel y, on a lift whatever the stale point registers hold
+ * @param [in] pressed false to lift the finger
+ */
+void ft6206_emul_touch(const struct emul *target, uint16_t x, uint16_t y, bool pressed) {
+  ft6206_emul_data *data = target->data;
+  k_spinlock_key_t key = k_spin_lock(&data->lock);
+  uint8_t event = !pressed ? FT6206_EMUL_EVENT_UP :
+                  data->pressed ? FT6206_EMUL_EVENT_CONTACT : FT6206_EMUL_EVENT_DOWN;
+
+  data->pressed = pressed;
+  data->regs[FT6206_EMUL_REG_TD_STATUS] = pressed ? 1 : 0;
+  data->regs[FT6206_EMUL_REG_P1_XH] = (event << 6) | ((x >> 8) & 0x0F);
+  data->regs[FT6206_EMUL_REG_P1_XH + 1] = x & 0xFF;
+  data->regs[FT6206_EMUL_REG_P1_XH + 2] = (y >> 8) & 0x0F;
+  data->regs[FT6206_EMUL_REG_P1_XH + 3] = y & 0xFF;
+  // Under the lock so a concurrent status read can't release it unseen
+  _ft6206_emul_int(target, true);
+  k_spin_unlock(&data->lock, key);
+}
+
+/**
+ * @brief Number of times the driver read the touch status
+ *
+ * @param [in] target The ft6206 emulator
+ *
+ * @return Read count
+ */
+uint32_t ft6206_emul_read_count(const struct emul *target) {
+  ft6206_emul_data *data = target->data;
+
+  return data->read_count;
+}
+
+/* ----------------------------------------------------------------------------
+                                  Instances
+---------------------------------------------------------------------------- */
+#define FT6206_EMUL_DEFINE(n)                                                       \
+  static const ft6206_emul_config _ft6206_emul_config_##n = {                       \
+    .int_gpio = GPIO_DT_SPEC_INST_GET(n, int_gpios),                                \
+  };                                                                                \
+  static ft6206_emul_data _ft6206_emul_data_##n;                                    \
+  EMUL_DT_INST_DEFINE(n, _ft6206_emul_init, &_ft6206_emul_data_##n,                 \
+                      &_ft6206_emul_config_##n, &_ft6206_emul_api, NULL);
+
+DT_INST_FOREACH_STATUS_OKAY(FT6206_EMUL_DEFINE)
@@ -0,0 +1,19 @@
+/*
+Header to define the FT6206 I2C emulator backend
+*/
+
+#ifndef FT6206_EMUL_H
+#define FT6206_EMUL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <zephyr/drivers/emul.h>
+
+/* ----------------------------------------------------------------------------
+                              Public Functions
+---------------------------------------------------------------------------- */
+void ft6206_emul_touch(const struct emul *target, uint16_t x, uint16_t y, bool pressed);
+
+uint32_t ft6206_emul_read_count(const struct emul *target);
+
+#endif
@@ -28,6 +28,9 @@ typedef struct _lv_data_obj_t {
  * Prototypes
  **********************************************************************/
 
+static void *lv_data_obj_mem_alloc(size_t size);
+static void lv_data_obj_mem_free(void *mem);
+
 static void lv_data_obj_constructor(const lv_obj_class_t *class_p,
                                     lv_obj_t *obj);
 static void lv_data_obj_destructor(const lv_obj_class_t *class_p,
@@ -48,6 +51,13 @@ const lv_obj_class_t lv_data_obj_class = {
     .name = "lv_data_obj",
 };
 
+#ifdef CONFIG_EIE_LV_DATA_OBJ_SLAB
+/* Data blocks live here instead of the LVGL pool */
+K_MEM_SLAB_DEFINE_STATIC(lv_data_obj_slab,
+                         ROUND_UP(CONFIG_EIE_LV_DATA_OBJ_BLOCK_SIZE, sizeof(void *)),
+                         CONFIG_EIE_LV_DATA_OBJ_BLOCKS, sizeof(void *));
+#endif
+
 /***********************************************************************
  * Functions
  **********************************************************************/
@@ -64,7 +74,8 @@ bool lv_data_obj_allocate(lv_obj_t const *obj, size_t size) {
     return false;
   }
   lv_data_obj_t *data_obj = (lv_data_obj_t *)obj;
-  data_obj->data = lv_malloc_zeroed(size);
+  lv_data_obj_mem_free(data_obj->data);
+  data_obj->data = lv_data_obj_mem_alloc(size);
 
   return data_obj->data != NULL;
 }
@@ -100,5 +111,31 @@ static void lv_data_obj_constructor(
 static void lv_data_obj_destructor(
     const lv_obj_class_t __attribute__((unused)) * class_p, lv_obj_t *obj) {
   lv_data_obj_t *data_obj = (lv_data_obj_t *)obj;
-  lv_free(data_obj->data);
+  lv_data_obj_mem_free(data_obj->data);
+}
+
+static void *lv_data_obj_mem_alloc(size_t size) {
+#ifdef CONFIG_EIE_LV_DATA_OBJ_SLAB
+  void *mem = NULL;
+
+  if (size > CONFIG_EIE_LV_DATA_OBJ_BLOCK_SIZE ||
+      k_mem_slab_alloc(&lv_data_obj_slab, &mem, K_NO_WAIT)) {
+    return NULL;
+  }
+  memset(mem, 0, size);
+  return mem;
+#else
+  return lv_malloc_zeroed(size);
+#endif
+}
+
+static void lv_data_obj_mem_free(void *mem) {
+  if (mem == NULL) {
+    return;
+  }
+#ifdef CONFIG_EIE_LV_DATA_OBJ_SLAB
+  k_mem_slab_free(&lv_data_obj_slab, mem);
+#else
+  lv_free(mem);
+#endif
 }
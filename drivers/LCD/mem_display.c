@@ -0,0 +1,201 @@
+/*
+In-memory RGB565 display driver
+*/
+
+#define DT_DRV_COMPAT eie_mem_display
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/display.h>
+#include <zephyr/sys/crc.h>
+#include <string.h>
+
+#include "mem_display.h"
+
+/* ----------------------------------------------------------------------------
+                                    Constants
+---------------------------------------------------------------------------- */
+#define MEM_DISPLAY_BPP           2 // RGB565
+
+/* ----------------------------------------------------------------------------
+                                    Types
+---------------------------------------------------------------------------- */
+typedef struct mem_display_config_t {
+  uint16_t width;
+  uint16_t height;
+  uint8_t *fb; // NULL without CONFIG_EIE_MEM_DISPLAY_FRAMEBUFFER
+} mem_display_config;
+
+typedef struct mem_display_data_t {
+  struct k_spinlock lock;
+  mem_display_stats stats;
+  uint32_t crc; // Running CRC of flushed data when no framebuffer is kept
+  bool blanked;
+} mem_display_data;
+
+/* ----------------------------------------------------------------------------
+                              Private Functions
+---------------------------------------------------------------------------- */
+static int _mem_display_blanking_on(const struct device *dev) {
+  mem_display_data *data = dev->data;
+
+  data->blanked = true;
+  return 0;
+}
+
+static int _mem_display_blanking_off(const struct device *dev) {
+  mem_display_data *data = dev->data;
+
+  data->blanked = false;
+  return 0;
+}
+
+static int _mem_display_write(const struct device *dev, const uint16_t x, const uint16_t y,
+                              const struct display_buffer_descriptor *desc, const void *buf) {
+  const mem_display_config *config = dev->config;
+  mem_display_data *data = dev->data;
+  uint32_t area = desc->width * desc->height;
+
+  if (x + desc->width > config->width || y + desc->height > config->height) {
+    return -EINVAL;
+  }
+
+  k_spinlock_key_t key = k_spin_lock(&data->lock);
+
+  if (config->fb) {
+    const uint8_t *src = buf;
+    for (uint16_t row = 0; row < desc->height; row++) {
+      memcpy(&config->fb[((y + row) * config->width + x) * MEM_DISPLAY_BPP],
+             &src[row * desc->pitch * MEM_DISPLAY_BPP], desc->width * MEM_DISPLAY_BPP);
+    }
+  } else {
+    data->crc = crc32_ieee_update(data->crc, buf, area * MEM_DISPLAY_BPP);
+  }
+
+  data->stats.writes++;
+  data->stats.pixels += area;
+  data->stats.max_area = MAX(data->stats.max_area, area);
+  if (!desc->frame_incomplete) {
+    data->stats.frames++;
+  }
+  k_spin_unlock(&data->lock, key);
+
+  return 0;
+}
+
+static void _mem_display_get_capabilities(const struct device *dev,
+                                          struct display_capabilities *caps) {
+  const mem_display_config *config = dev->config;
+
+  memset(caps, 0, sizeof(*caps));
+  caps->x_resolution = config->width;
+  caps->y_resolution = config->height;
+  caps->supported_pixel_formats = PIXEL_FORMAT_RGB_565;
+  caps->current_pixel_format = PIXEL_FORMAT_RGB_565;
+  caps->current_orientation = DISPLAY_ORIENTATION_NORMAL;
+}
+
+static int _mem_display_set_pixel_format(const struct device *dev,
+                                         const enum display_pixel_format format) {
+  return (format == PIXEL_FORMAT_RGB_565) ? 0 : -ENOTSUP;
+}
+
+static int _mem_display_init(const struct device *dev) {
+  mem_display_data *data = dev->data;
+
+  mem_display_stats_reset(dev);
+  data->blanked = true;
+  return 0;
+}
+
+static DEVICE_API(display, _mem_display_api) = {
+  .blanking_on = _mem_display_blanking_on,
+  .blanking_off = _mem_display_blanking_off,
+  .write = _mem_display_write,
+  .get_capabilities = _mem_display_get_capabilities,
+  .set_pixel_format = _mem_display_set_pixel_format,
+};
+
+/* ----------------------------------------------------------------------------
+                              Public Functions
+---------------------------------------------------------------------------- */
+/**
+ * @brief Copy the flush statistics of a display
+ *
+ * @param [in] dev The mem-display instance
+ * @param [out] stats Destination
+ *
+ * @return Error code, < 0 on failures
+ */
+int mem_display_stats_get(const struct device *dev, mem_display_stats *stats) {
+  mem_display_data *data = dev->data;
+
+  if (!device_is_ready(dev)) {
+    return -ENODEV;
+  }
+
+  k_spinlock_key_t key = k_spin_lock(&data->lock);
+  *stats = data->stats;
+  k_spin_unlock(&data->lock, key);
+  return 0;
+}
+
+/**
+ * @brief Clear the flush statistics and the running checksum
+ *
+ * @param [in] dev The mem-display instance
+ */
+void mem_display_stats_reset(const struct device *dev) {
+  mem_display_data *data = dev->data;
+
+  k_spinlock_key_t key = k_spin_lock(&data->lock);
+  memset(&data->stats, 0, sizeof(data->stats));
+  data->crc = 0;
+  k_spin_unlock(&data->lock, key);
+}
+
+/**
+ * @brief Checksum of the displayed content
+ *
+ * CRC-32 of the whole frame when a framebuffer is kept, otherwise of all
+ * data flushed since the last reset.
+ *
+ * @param [in] dev The mem-display instance
+ *
+ * @return CRC-32 (IEEE)
+ */
+uint32_t mem_display_checksum(const struct device *dev) {
+  const mem_display_config *config = dev->config;
+  mem_display_data *data = dev->data;
+  uint32_t crc;
+
+  k_spinlock_key_t key = k_spin_lock(&data->lock);
+  if (config->fb) {
+    crc = crc32_ieee(config->fb, config->width * config->height * MEM_DISPLAY_BPP);
+  } else {
+    crc = data->crc;
+  }
+  k_spin_unlock(&data->lock, key);
+  return crc;
+}
+
+/* ----------------------------------------------------------------------------
+                                  Instances
+---------------------------------------------------------------------------- */
+#define MEM_DISPLAY_FB_SIZE(n) (DT_INST_PROP(n, width) * DT_INST_PROP(n, height) * MEM_DISPLAY_BPP)
+
+#define MEM_DISPLAY_DEFINE(n)                                                       \
+  IF_ENABLED(CONFIG_EIE_MEM_DISPLAY_FRAMEBUFFER,                                    \
+             (static uint8_t _mem_display_fb_##n[MEM_DISPLAY_FB_SIZE(n)];))         \
+  static const mem_display_config _mem_display_config_##n = {                      \
+    .width = DT_INST_PROP(n, width),                                                \
+    .height = DT_INST_PROP(n, height),                                              \
+    .fb = COND_CODE_1(CONFIG_EIE_MEM_DISPLAY_FRAMEBUFFER,                           \
+                      (_mem_display_fb_##n), (NULL)),                               \
+  };                                                                                \
+  static mem_display_data _mem_display_data_##n;                                    \
+  DEVICE_DT_INST_DEFINE(n, _mem_display_init, NULL, &_mem_display_data_##n,         \
+                        &_mem_display_config_##n, POST_KERNEL,                      \
+                        CONFIG_DISPLAY_INIT_PRIORITY, &_mem_display_api);
+
+DT_INST_FOREACH_STATUS_OKAY(MEM_DISPLAY_DEFINE)
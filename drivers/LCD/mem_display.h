@@ -0,0 +1,30 @@
+/*
+Header to define the in-memory display interface
+*/
+
+#ifndef MEM_DISPLAY_H
+#define MEM_DISPLAY_H
+
+#include <stdint.h>
+#include <zephyr/device.h>
+
+/* ----------------------------------------------------------------------------
+                                    TYPES
+---------------------------------------------------------------------------- */
+typedef struct mem_display_stats_t {
+  uint32_t writes;         // Number of display_write() calls
+  uint32_t frames;         // Writes that completed a frame (frame_incomplete == false)
+  uint64_t pixels;         // Total pixels flushed
+  uint32_t max_area;       // Largest single write in pixels
+} mem_display_stats;
+
+/* ----------------------------------------------------------------------------
+                              Public Functions
+---------------------------------------------------------------------------- */
+int mem_display_stats_get(const struct device *dev, mem_display_stats *stats);
+
+void mem_display_stats_reset(const struct device *dev);
+
+uint32_t mem_display_checksum(const struct device *dev);
+
+#endif
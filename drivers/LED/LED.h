@@ -31,6 +31,11 @@ typedef enum led_frequency_t {
   LED_16HZ = 16,
 } led_frequency;
 
+/* ----------------------------------------------------------------------------
+                                  CONSTANTS
+---------------------------------------------------------------------------- */
+#define LED_BLINK_PERIOD_MS   (500 / LED_16HZ) // One pass of the blink loop: half a period at the highest frequency
+
 /* ----------------------------------------------------------------------------
                               Public Functions
 ---------------------------------------------------------------------------- */
@@ -44,4 +49,8 @@ int LED_pwm(led_id led, uint8_t duty_cycle);
 
 void LED_blink(led_id led, led_frequency frequency);
 
+int LED_suspend();
+
+int LED_resume();
+
 #endif
\ No newline at end of file
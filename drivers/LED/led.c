@@ -4,10 +4,14 @@ Header to define led module logic
 
 #include <zephyr/kernel.h>
 #include <zephyr/drivers/pwm.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/pm/device_runtime.h>
 #include <inttypes.h>
 
 #include "LED.h"
 
+LOG_MODULE_REGISTER(LED, CONFIG_LOG_DEFAULT_LEVEL);
+
 /* ----------------------------------------------------------------------------
                                     Constants
 ---------------------------------------------------------------------------- */
@@ -53,10 +57,14 @@ typedef struct blink_thread_t {
 ---------------------------------------------------------------------------- */
 static int _led_pwm_preserve_blink(led_id led, uint8_t duty_cycle);
 
+static int _led_toggle(led_id led);
+
 static void _led_halt_blink(led_id led);
 
 static void _led_blink_loop(void *led, void *p2, void *p3);
 
+static void _led_pm(bool on);
+
 /* ----------------------------------------------------------------------------
                                 Global States
 ---------------------------------------------------------------------------- */
@@ -67,13 +75,19 @@ static led_type _led3 = {.spec=PWM_DT_SPEC_GET(LED3_NODE), .current_duty_cycle=0
 static led_type *_leds[NUM_LEDS] = {&_led0, &_led1, &_led2, &_led3};
 
 static blink_thread _led_blink_thread = {.led_bitmask=0};
+static bool _led_suspended = false;
+// Guards the duty cycles, blink state, _led_suspended and the PWM outputs
+static struct k_spinlock _led_lock;
+// Serializes LED_suspend() and LED_resume(), the PM calls may sleep
+static K_MUTEX_DEFINE(_led_pm_lock);
 K_THREAD_STACK_DEFINE(_led_blink_stack, LED_BLINK_STACK_SIZE);
 
 /* ----------------------------------------------------------------------------
                               Private Functions
 ---------------------------------------------------------------------------- */
 /**
- * @brief Sets the LED to the given duty cycle, doesn't halt blinking
+ * @brief Sets the LED to the given duty cycle, doesn't halt blinking. Called
+ *        with _led_lock held
  * 
  * @param [in] led the LED to set the duty cycle of
  * @param [in] duty_cycle the duty cycle to set the LED to
@@ -85,13 +99,37 @@ static int _led_pwm_preserve_blink(led_id led, uint8_t duty_cycle) {
     return -EINVAL;
   }
   uint8_t clamped_duty_cycle = PWM_MAX_DUTY_CYCLE < duty_cycle ? PWM_MAX_DUTY_CYCLE : duty_cycle;
+  _leds[led]->current_duty_cycle = clamped_duty_cycle;
+  if (_led_suspended) {
+    // Applied by LED_resume()
+    return 0;
+  }
   uint32_t pwm_step = _leds[led]->spec.period / PWM_MAX_DUTY_CYCLE;
   // Subtract clamped duty cycle as leds are active low
   return pwm_set_pulse_dt(&_leds[led]->spec, pwm_step * (PWM_MAX_DUTY_CYCLE - clamped_duty_cycle));
 }
 
 /**
- * @brief Halts blinking for the given LED
+ * @brief Toggles the given LED, doesn't halt blinking. Called with _led_lock held
+ * 
+ * @param [in] led the LED instance to toggle
+ * 
+ * @return Error code, < 0 on failures
+ */
+static int _led_toggle(led_id led) {
+  if (IS_INVALID_LED(led)) {
+    return -EINVAL;
+  }
+  if (0 == _leds[led]->current_duty_cycle) {
+    _leds[led]->current_duty_cycle = PWM_MAX_DUTY_CYCLE;
+  } else {
+    _leds[led]->current_duty_cycle = 0;
+  }
+  return _led_pwm_preserve_blink(led, _leds[led]->current_duty_cycle);
+}
+
+/**
+ * @brief Halts blinking for the given LED. Called with _led_lock held
  * 
  * @param [in] led the LED instance to halt blinking for
  */
@@ -117,17 +155,42 @@ static void _led_blink_loop(void *p1 __attribute__((unused)), void *p2 __attribu
   uint16_t min_half_period = LED_COUNTER_HALF_PERIOD / LED_16HZ;
 
   while (1) {
-    k_msleep(min_half_period / LED_COUNTER_UNIT);
+    k_msleep(LED_BLINK_PERIOD_MS);
 
+    k_spinlock_key_t key = k_spin_lock(&_led_lock);
     for (int i = 0; i < NUM_LEDS; i++) {
       if (_led_blink_thread.led_bitmask & BIT(i)) {
         _leds[i]->blink.offset += min_half_period;
         if (_leds[i]->blink.offset >= _leds[i]->blink.half_period){
           _leds[i]->blink.offset = 0;
-          LED_toggle(i);
+          _led_toggle(i);
         }
       }
     }
+    k_spin_unlock(&_led_lock, key);
+  }
+}
+
+/**
+ * @brief Takes or releases a runtime PM reference on each PWM controller used by the LEDs
+ * 
+ * @param [in] on true to power the controllers, false to let them suspend
+ */
+static void _led_pm(bool on) {
+  for (int i = 0; i < NUM_LEDS; i++) {
+    const struct device *dev = _leds[i]->spec.dev;
+    bool seen = false;
+
+    for (int j = 0; j < i; j++) {
+      seen |= (_leds[j]->spec.dev == dev);
+    }
+    if (seen) {
+      continue;
+    } else if (on) {
+      pm_device_runtime_get(dev);
+    } else {
+      pm_device_runtime_put(dev);
+    }
   }
 }
 
@@ -143,6 +206,7 @@ int LED_init() {
   for (int i = 0; i < NUM_LEDS; i++) {
     int rv = pwm_is_ready_dt(&_leds[i]->spec);
     if (rv < 0) {
+      LOG_ERR("LED%d PWM not ready", i);
       return rv;
     }
   }
@@ -157,7 +221,14 @@ int LED_init() {
     0,
     K_NO_WAIT
   );
+  k_thread_name_set(_led_blink_thread.id, "led_blink");
   k_thread_suspend(_led_blink_thread.id);
+
+  // Controllers without PM support just stay powered
+  for (int i = 0; i < NUM_LEDS; i++) {
+    pm_device_runtime_enable(_leds[i]->spec.dev);
+  }
+  _led_pm(true);
   
   return 0;
 }
@@ -172,14 +243,12 @@ int LED_init() {
 int LED_toggle(led_id led) {
   if (IS_INVALID_LED(led)) {
     return -EINVAL;
-  } else {
-    if (0 == _leds[led]->current_duty_cycle) {
-      _leds[led]->current_duty_cycle = PWM_MAX_DUTY_CYCLE;
-    } else {
-      _leds[led]->current_duty_cycle = 0;
-    }
-    return _led_pwm_preserve_blink(led, _leds[led]->current_duty_cycle);
   }
+
+  k_spinlock_key_t key = k_spin_lock(&_led_lock);
+  int rv = _led_toggle(led);
+  k_spin_unlock(&_led_lock, key);
+  return rv;
 }
 
 /**
@@ -195,10 +264,11 @@ int LED_set(led_id led, led_state new_state) {
     return -EINVAL;
   }
 
+  k_spinlock_key_t key = k_spin_lock(&_led_lock);
   _led_halt_blink(led);
-
-  _leds[led]->current_duty_cycle = (0 == new_state) ? 0 : PWM_MAX_DUTY_CYCLE;
-  return LED_pwm(led, _leds[led]->current_duty_cycle);
+  int rv = _led_pwm_preserve_blink(led, (0 == new_state) ? 0 : PWM_MAX_DUTY_CYCLE);
+  k_spin_unlock(&_led_lock, key);
+  return rv;
 }
 
 /**
@@ -214,9 +284,11 @@ int LED_pwm(led_id led, uint8_t duty_cycle) {
     return -EINVAL;
   }
 
+  k_spinlock_key_t key = k_spin_lock(&_led_lock);
   _led_halt_blink(led);
-
-  return _led_pwm_preserve_blink(led, duty_cycle);
+  int rv = _led_pwm_preserve_blink(led, duty_cycle);
+  k_spin_unlock(&_led_lock, key);
+  return rv;
 }
 
 /**
@@ -232,12 +304,73 @@ void LED_blink(led_id led, led_frequency frequency) {
     return;
   }
 
+  k_spinlock_key_t key = k_spin_lock(&_led_lock);
   _leds[led]->blink.half_period = LED_COUNTER_HALF_PERIOD / frequency;
   _leds[led]->blink.offset = 0;
 
-  if (!_led_blink_thread.led_bitmask) {
+  if (!_led_blink_thread.led_bitmask && !_led_suspended) {
     k_thread_resume(_led_blink_thread.id);
   }
 
   _led_blink_thread.led_bitmask |= BIT(led);
+  k_spin_unlock(&_led_lock, key);
+}
+
+/**
+ * @brief Stops blinking and powers down the PWM controllers. LED calls made
+ *        while suspended are remembered and applied by LED_resume()
+ * 
+ * @return Error code, < 0 on failures
+ */
+int LED_suspend() {
+  k_mutex_lock(&_led_pm_lock, K_FOREVER);
+  k_spinlock_key_t key = k_spin_lock(&_led_lock);
+  if (_led_suspended) {
+    k_spin_unlock(&_led_lock, key);
+    k_mutex_unlock(&_led_pm_lock);
+    return -EALREADY;
+  }
+  k_thread_suspend(_led_blink_thread.id);
+  // Drive every LED off (active low) so nothing stays lit through the sleep pin state
+  for (int i = 0; i < NUM_LEDS; i++) {
+    pwm_set_pulse_dt(&_leds[i]->spec, _leds[i]->spec.period);
+  }
+  _led_suspended = true;
+  k_spin_unlock(&_led_lock, key);
+
+  // Outputs see _led_suspended from here on and leave the controllers alone
+  _led_pm(false);
+  k_mutex_unlock(&_led_pm_lock);
+  return 0;
+}
+
+/**
+ * @brief Powers the PWM controllers back up and restores every LED's duty
+ *        cycle and blinking
+ * 
+ * @return Error code, < 0 on failures
+ */
+int LED_resume() {
+  int rv = 0;
+
+  k_mutex_lock(&_led_pm_lock, K_FOREVER);
+  // Only LED_suspend() sets it and it holds _led_pm_lock too
+  if (!_led_suspended) {
+    k_mutex_unlock(&_led_pm_lock);
+    return -EALREADY;
+  }
+  _led_pm(true);
+
+  k_spinlock_key_t key = k_spin_lock(&_led_lock);
+  _led_suspended = false;
+  for (int i = 0; i < NUM_LEDS && rv >= 0; i++) {
+    rv = _led_pwm_preserve_blink(i, _leds[i]->current_duty_cycle);
+  }
+  if (_led_blink_thread.led_bitmask) {
+    k_thread_resume(_led_blink_thread.id);
+  }
+  k_spin_unlock(&_led_lock, key);
+
+  k_mutex_unlock(&_led_pm_lock);
+  return rv;
 }
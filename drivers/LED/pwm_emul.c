@@ -0,0 +1,116 @@
+/*
+Emulated PWM controller, records the last setting of each channel
+*/
+
+#define DT_DRV_COMPAT eie_pwm_emul
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/pwm.h>
+
+#include "pwm_emul.h"
+
+/* ----------------------------------------------------------------------------
+                                    Types
+---------------------------------------------------------------------------- */
+typedef struct pwm_emul_channel_t {
+  uint32_t period; // Cycles
+  uint32_t pulse; // Cycles
+} pwm_emul_channel;
+
+typedef struct pwm_emul_config_t {
+  uint32_t channels;
+  uint32_t frequency; // Hz
+} pwm_emul_config;
+
+typedef struct pwm_emul_data_t {
+  pwm_emul_channel *channels;
+  uint32_t set_count; // Number of set_cycles calls, for benchmarks
+} pwm_emul_data;
+
+/* ----------------------------------------------------------------------------
+                              Private Functions
+---------------------------------------------------------------------------- */
+static int _pwm_emul_set_cycles(const struct device *dev, uint32_t channel,
+                                uint32_t period_cycles, uint32_t pulse_cycles, pwm_flags_t flags) {
+  const pwm_emul_config *config = dev->config;
+  pwm_emul_data *data = dev->data;
+
+  if (channel >= config->channels || pulse_cycles > period_cycles) {
+    return -EINVAL;
+  }
+
+  data->channels[channel].period = period_cycles;
+  data->channels[channel].pulse = pulse_cycles;
+  data->set_count++;
+  return 0;
+}
+
+static int _pwm_emul_get_cycles_per_sec(const struct device *dev, uint32_t channel,
+                                        uint64_t *cycles) {
+  const pwm_emul_config *config = dev->config;
+
+  if (channel >= config->channels) {
+    return -EINVAL;
+  }
+  *cycles = config->frequency;
+  return 0;
+}
+
+static DEVICE_API(pwm, _pwm_emul_api) = {
+  .set_cycles = _pwm_emul_set_cycles,
+  .get_cycles_per_sec = _pwm_emul_get_cycles_per_sec,
+};
+
+/* ----------------------------------------------------------------------------
+                              Public Functions
+---------------------------------------------------------------------------- */
+/**
+ * @brief Read back the last setting of a channel
+ *
+ * @param [in] dev The pwm-emul instance
+ * @param [in] channel The channel to read
+ * @param [out] period Last period in cycles
+ * @param [out] pulse Last pulse width in cycles
+ *
+ * @return Error code, < 0 on failures
+ */
+int pwm_emul_get(const struct device *dev, uint32_t channel, uint32_t *period, uint32_t *pulse) {
+  const pwm_emul_config *config = dev->config;
+  pwm_emul_data *data = dev->data;
+
+  if (channel >= config->channels) {
+    return -EINVAL;
+  }
+  *period = data->channels[channel].period;
+  *pulse = data->channels[channel].pulse;
+  return 0;
+}
+
+/**
+ * @brief Number of times any channel was set since boot
+ *
+ * @param [in] dev The pwm-emul instance
+ *
+ * @return Set count
+ */
+uint32_t pwm_emul_set_count(const struct device *dev) {
+  pwm_emul_data *data = dev->data;
+
+  return data->set_count;
+}
+
+/* ----------------------------------------------------------------------------
+                                  Instances
+---------------------------------------------------------------------------- */
+#define PWM_EMUL_DEFINE(n)                                                          \
+  static pwm_emul_channel _pwm_emul_channels_##n[DT_INST_PROP(n, channels)];        \
+  static const pwm_emul_config _pwm_emul_config_##n = {                             \
+    .channels = DT_INST_PROP(n, channels),                                          \
+    .frequency = DT_INST_PROP(n, clock_frequency),                                  \
+  };                                                                                \
+  static pwm_emul_data _pwm_emul_data_##n = {.channels = _pwm_emul_channels_##n};   \
+  DEVICE_DT_INST_DEFINE(n, NULL, NULL, &_pwm_emul_data_##n, &_pwm_emul_config_##n,  \
+                        POST_KERNEL, CONFIG_PWM_INIT_PRIORITY, &_pwm_emul_api);
+
+DT_INST_FOREACH_STATUS_OKAY(PWM_EMUL_DEFINE)
@@ -0,0 +1,18 @@
+/*
+Header to define the emulated PWM controller interface
+*/
+
+#ifndef PWM_EMUL_H
+#define PWM_EMUL_H
+
+#include <stdint.h>
+#include <zephyr/device.h>
+
+/* ----------------------------------------------------------------------------
+                              Public Functions
+---------------------------------------------------------------------------- */
+int pwm_emul_get(const struct device *dev, uint32_t channel, uint32_t *period, uint32_t *pulse);
+
+uint32_t pwm_emul_set_count(const struct device *dev);
+
+#endif
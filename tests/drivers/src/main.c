@@ -0,0 +1,330 @@
+/**
+ * @file main.c
+ * @brief Cycle-count benchmarks of the BTN, LED, FT6206 and lv_data_obj
+ *        drivers
+ *
+ * Every measurement prints one line "BENCH {json}" with min/avg/max cycles
+ * and the average in ns, and fails its test when the average crosses the
+ * CONFIG_BENCH_*_MAX_NS bound. Button edges are injected through the GPIO
+ * emulator and touches through the FT6206 I2C emulator, so the measured paths
+ * are the real driver ISRs.
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/device.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/timing/timing.h>
+#include <zephyr/drivers/emul.h>
+#include <zephyr/drivers/gpio/gpio_emul.h>
+
+#include <lvgl.h>
+#include <lvgl_mem.h>
+
+#include "BTN.h"
+#include "FT6206.h"
+#include "ft6206_emul.h"
+#include "LED.h"
+#include "lv_data_obj.h"
+
+/* --------------------------------------------------------------------------
+ * Constants
+ * -------------------------------------------------------------------------- */
+#define ITERATIONS      CONFIG_BENCH_ITERATIONS
+#define TOUCH_MOVES     8  /* reports between press and release of a stroke */
+
+/* --------------------------------------------------------------------------
+ * Types
+ * -------------------------------------------------------------------------- */
+struct bench_stats {
+    uint32_t n;
+    uint64_t sum;
+    uint64_t min;
+    uint64_t max;
+};
+
+/* --------------------------------------------------------------------------
+ * Global States
+ * -------------------------------------------------------------------------- */
+static const struct device *const btn_port = DEVICE_DT_GET(DT_NODELABEL(bench_gpio));
+static const struct device *const touch_dev = DEVICE_DT_GET(DT_NODELABEL(bench_touch));
+static const struct emul *const touch_emul = EMUL_DT_GET(DT_NODELABEL(bench_touch));
+
+static k_tid_t blink_tid;
+
+/* --------------------------------------------------------------------------
+ * Private Functions
+ * -------------------------------------------------------------------------- */
+static void stats_add(struct bench_stats *st, timing_t *start, timing_t *end)
+{
+    uint64_t cycles = timing_cycles_get(start, end);
+
+    st->min = (st->n == 0U) ? cycles : MIN(st->min, cycles);
+    st->max = MAX(st->max, cycles);
+    st->sum += cycles;
+    st->n++;
+}
+
+/* Print the measurement, then hold its average to max_ns */
+static void stats_check(const char *name, const struct bench_stats *st, uint32_t max_ns)
+{
+    uint64_t avg = st->n ? st->sum / st->n : 0U;
+    uint64_t avg_ns = timing_cycles_to_ns(avg);
+
+    printk("BENCH {\"name\":\"%s\",\"n\":%u,\"min_cycles\":%llu,"
+           "\"avg_cycles\":%llu,\"max_cycles\":%llu,\"avg_ns\":%llu}\n",
+           name, st->n, st->min, avg, st->max, avg_ns);
+    zassert_true(st->n > 0U, "%s: nothing measured", name);
+    zassert_true(avg_ns <= max_ns, "%s: %llu ns on average, bound is %u ns", name, avg_ns,
+                 max_ns);
+}
+
+static void find_blink_thread(const struct k_thread *thread, void *user_data)
+{
+    const char *name = k_thread_name_get((k_tid_t)thread);
+
+    if (name && !strcmp(name, "led_blink")) {
+        blink_tid = (k_tid_t)thread;
+    }
+}
+
+static void *drivers_setup(void)
+{
+    /* Buttons idle high (pull-up, active low) before the driver looks */
+    for (int i = 0; i < NUM_BTNS; i++) {
+        gpio_emul_input_set(btn_port, i, 1);
+    }
+
+    zassert_ok(BTN_init(), "BTN init failed");
+    zassert_ok(LED_init(), "LED init failed");
+
+    timing_init();
+    timing_start();
+    return NULL;
+}
+
+static void drivers_teardown(void *fixture)
+{
+    ARG_UNUSED(fixture);
+    timing_stop();
+}
+
+/* --------------------------------------------------------------------------
+ * Tests
+ * -------------------------------------------------------------------------- */
+/* GPIO edge -> _btn_interrupt_service_routine -> debounce reschedule */
+ZTEST(drivers, test_btn_isr)
+{
+    struct bench_stats st = {0};
+
+    for (int i = 0; i < ITERATIONS; i++) {
+        timing_t start = timing_counter_get();
+
+        /* Active low: falling edge is the press */
+        gpio_emul_input_set(btn_port, BTN0, 0);
+        timing_t end = timing_counter_get();
+
+        stats_add(&st, &start, &end);
+        gpio_emul_input_set(btn_port, BTN0, 1);
+    }
+    stats_check("btn_isr_dispatch", &st, CONFIG_BENCH_BTN_ISR_MAX_NS);
+
+    /* Let the pending debounce run out: the pin is released, so the bursts
+     * of edges must not have recorded a press */
+    k_msleep(2 * BTN_DEBOUNCE_MS);
+    zassert_false(BTN_check_clear_pressed(BTN0), "bounces recorded as a press");
+}
+
+ZTEST(drivers, test_btn_check_clear)
+{
+    struct bench_stats st = {0};
+    volatile bool sink;
+
+    for (int i = 0; i < ITERATIONS; i++) {
+        timing_t start = timing_counter_get();
+
+        sink = BTN_check_clear_pressed(i % NUM_BTNS);
+        timing_t end = timing_counter_get();
+
+        stats_add(&st, &start, &end);
+    }
+    ARG_UNUSED(sink);
+    stats_check("btn_check_clear_pressed", &st, CONFIG_BENCH_BTN_CHECK_MAX_NS);
+}
+
+ZTEST(drivers, test_led_pwm)
+{
+    struct bench_stats st = {0};
+
+    for (int i = 0; i < ITERATIONS; i++) {
+        timing_t start = timing_counter_get();
+
+        LED_pwm(LED0, i % 101);
+        timing_t end = timing_counter_get();
+
+        stats_add(&st, &start, &end);
+    }
+    stats_check("led_pwm", &st, CONFIG_BENCH_LED_PWM_MAX_NS);
+}
+
+ZTEST(drivers, test_led_toggle)
+{
+    struct bench_stats st = {0};
+
+    for (int i = 0; i < ITERATIONS; i++) {
+        timing_t start = timing_counter_get();
+
+        LED_toggle(LED1);
+        timing_t end = timing_counter_get();
+
+        stats_add(&st, &start, &end);
+    }
+    stats_check("led_toggle", &st, CONFIG_BENCH_LED_TOGGLE_MAX_NS);
+}
+
+/* Blink loop cost from the thread's own runtime, all four LEDs blinking */
+ZTEST(drivers, test_led_blink_loop)
+{
+    k_thread_runtime_stats_t before;
+    k_thread_runtime_stats_t after;
+
+    k_thread_foreach(find_blink_thread, NULL);
+    zassert_not_null(blink_tid, "led_blink thread not found");
+
+    k_thread_runtime_stats_get(blink_tid, &before);
+    for (int i = 0; i < NUM_LEDS; i++) {
+        LED_blink(i, LED_16HZ);
+    }
+    k_msleep(CONFIG_BENCH_BLINK_WINDOW_MS);
+    k_thread_runtime_stats_get(blink_tid, &after);
+    for (int i = 0; i < NUM_LEDS; i++) {
+        LED_set(i, LED_OFF);
+    }
+
+    uint32_t passes = CONFIG_BENCH_BLINK_WINDOW_MS / LED_BLINK_PERIOD_MS;
+    uint64_t cycles = (after.execution_cycles - before.execution_cycles) / MAX(passes, 1U);
+    uint64_t ns = k_cyc_to_ns_floor64(cycles);
+
+    printk("BENCH {\"name\":\"led_blink_loop\",\"n\":%u,\"avg_cycles\":%llu,"
+           "\"avg_ns\":%llu}\n", passes, cycles, ns);
+    zassert_true(after.execution_cycles > before.execution_cycles, "blink loop never ran");
+    zassert_true(ns <= CONFIG_BENCH_LED_BLINK_MAX_NS,
+                 "led_blink_loop: %llu ns per pass, bound is %u ns", ns,
+                 CONFIG_BENCH_LED_BLINK_MAX_NS);
+}
+
+/* One stroke is a press, TOUCH_MOVES moves and a release. Paced: LVGL reads
+ * after every report. Burst: LVGL reads once per stroke, so moves coalesce. */
+static void bench_touch_strokes(lv_indev_t *indev, bool paced)
+{
+    struct bench_stats st = {0};
+    uint32_t reads = ft6206_emul_read_count(touch_emul);
+    ft6206_stats ts;
+
+    ft6206_stats_reset(touch_dev);
+    for (int i = 0; i < ITERATIONS / (TOUCH_MOVES + 2); i++) {
+        for (int r = 0; r < TOUCH_MOVES + 2; r++) {
+            timing_t start = timing_counter_get();
+
+            /* Edge -> ISR -> work item I2C read -> queued for LVGL */
+            ft6206_emul_touch(touch_emul, r, i % 64, r <= TOUCH_MOVES);
+            timing_t end = timing_counter_get();
+
+            stats_add(&st, &start, &end);
+            k_yield();
+            if (paced) {
+                lv_indev_read(indev);
+            }
+        }
+        if (!paced) {
+            lv_indev_read(indev);
+        }
+    }
+    ft6206_stats_get(touch_dev, &ts);
+
+    stats_check(paced ? "ft6206_report_paced" : "ft6206_report_burst", &st,
+                CONFIG_BENCH_TOUCH_REPORT_MAX_NS);
+    printk("BENCH {\"name\":\"%s\",\"reports\":%u,\"irqs\":%u,\"i2c_reads\":%u,"
+           "\"samples\":%u,\"coalesced\":%u,\"dropped\":%u,\"read_lat_max_us\":%u,"
+           "\"lat_min_us\":%u,\"lat_avg_us\":%u,\"lat_max_us\":%u}\n",
+           paced ? "ft6206_paced" : "ft6206_burst", st.n, ts.irqs,
+           ft6206_emul_read_count(touch_emul) - reads, ts.samples, ts.coalesced, ts.dropped,
+           ts.read_lat_max_us, ts.lat_min_us, ts.lat_avg_us, ts.lat_max_us);
+    zassert_equal(ts.read_errors, 0, "%u I2C read errors", ts.read_errors);
+    /* LVGL drains the queue after every report, so nothing may be lost */
+    if (paced) {
+        zassert_equal(ts.dropped, 0, "%u samples dropped while paced", ts.dropped);
+    }
+}
+
+/* The point registers are stale after a lift, LVGL must see the release
+ * where the finger last was */
+static void check_touch_release(lv_indev_t *indev)
+{
+    static const uint16_t path[][3] = {{10, 20, true}, {12, 22, true}, {63, 0, false}};
+    lv_point_t point;
+
+    for (int i = 0; i < ARRAY_SIZE(path); i++) {
+        ft6206_emul_touch(touch_emul, path[i][0], path[i][1], path[i][2]);
+        k_yield();
+        lv_indev_read(indev);
+    }
+    lv_indev_get_point(indev, &point);
+    zassert_equal(lv_indev_get_state(indev), LV_INDEV_STATE_RELEASED, "not released");
+    zassert_true(point.x == 12 && point.y == 22, "released at %d,%d, last pressed at 12,22",
+                 point.x, point.y);
+}
+
+ZTEST(drivers, test_touch)
+{
+    lv_indev_t *indev = ft6206_lvgl_register(touch_dev);
+
+    zassert_not_null(indev, "ft6206 not ready");
+    /* Reads are driven by the benchmark, not LVGL's timer */
+    lv_timer_pause(lv_indev_get_read_timer(indev));
+
+    check_touch_release(indev);
+    bench_touch_strokes(indev, true);
+    bench_touch_strokes(indev, false);
+    lv_indev_delete(indev);
+}
+
+ZTEST(drivers, test_lv_data_obj)
+{
+    static const uint8_t payload[32] = {0xA5};
+    struct bench_stats create = {0};
+    struct bench_stats destroy = {0};
+    struct sys_memory_stats heap_before;
+    struct sys_memory_stats heap_after;
+    lv_obj_t *scr = lv_screen_active();
+
+    lvgl_heap_stats(&heap_before);
+    for (int i = 0; i < ITERATIONS; i++) {
+        timing_t start = timing_counter_get();
+        lv_obj_t *obj = lv_data_obj_create_alloc_assign(scr, payload, sizeof(payload));
+        timing_t mid = timing_counter_get();
+
+        zassert_not_null(obj, "alloc failed at iteration %d", i);
+        lv_obj_delete(obj);
+        timing_t end = timing_counter_get();
+
+        stats_add(&create, &start, &mid);
+        stats_add(&destroy, &mid, &end);
+    }
+    lvgl_heap_stats(&heap_after);
+
+    printk("BENCH {\"name\":\"lv_data_obj_heap\",\"allocated_before\":%zu,"
+           "\"allocated_after\":%zu,\"max_allocated\":%zu}\n",
+           heap_before.allocated_bytes, heap_after.allocated_bytes,
+           heap_after.max_allocated_bytes);
+    /* Churn must not leak: allocated bytes return to where they started */
+    zassert_equal(heap_after.allocated_bytes, heap_before.allocated_bytes,
+                  "churn leaked: %zu bytes allocated before, %zu after",
+                  heap_before.allocated_bytes, heap_after.allocated_bytes);
+    stats_check("lv_data_obj_create_alloc_assign", &create, CONFIG_BENCH_LV_DATA_OBJ_MAX_NS);
+    stats_check("lv_data_obj_delete", &destroy, CONFIG_BENCH_LV_DATA_OBJ_MAX_NS);
+}
+
+ZTEST_SUITE(drivers, NULL, drivers_setup, NULL, NULL, drivers_teardown);